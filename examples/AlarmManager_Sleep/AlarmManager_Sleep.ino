@@ -0,0 +1,95 @@
+
+// CONNECTIONS:
+// DS3231 SDA --> SDA
+// DS3231 SCL --> SCL
+// DS3231 VCC --> 3.3v or 5v
+// DS3231 GND --> GND
+// SQW --->  (Pin2) Don't forget to pullup (4.7k to 10k to VCC)
+
+#include <Wire.h> // must be included here so that Arduino library object file references work
+#include <RtcDS3231.h>
+#include <RtcAlarmManager.h>
+#include <RtcAlarmHandoff.h>
+
+RtcDS3231<TwoWire> Rtc(Wire);
+
+// global instance of the manager 
+RtcAlarmManager Alarms;
+
+#define RtcSquareWavePin 2 // Uno
+
+// marked volatile so interrupt can safely modify them and
+// other code can safely read and modify them
+volatile bool interruptFlag = false;
+
+void ISR_ATTR interruptServiceRoutine()
+{
+    // since this interrupted any other running code,
+    // don't do anything that takes long and especially avoid
+    // any communications calls within this routine
+    interruptFlag = true;
+}
+
+void alarmCallback([[maybe_unused]] void* context, uint8_t id, [[maybe_unused]] const RtcDateTime& alarm)
+{
+    Serial.print("ALARM: ");
+    Serial.println(id);
+}
+
+void setup () 
+{
+    Serial.begin(115200);
+
+    Serial.println("Initializing...");
+    //--------Alarms SETUP ------------
+    Alarms.Begin(2);  // max active alarms we will use is two
+
+    //--------RTC SETUP ------------
+    pinMode(RtcSquareWavePin, INPUT);
+
+    Rtc.Begin();
+#if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(3000 /* us */, true /* reset_on_timeout */);
+#endif
+
+    // the alarm manager will use alarm one to wake us
+    Rtc.SetSquareWavePin(DS3231SquareWavePin_ModeAlarmOne);
+
+    RtcDateTime now = Rtc.GetDateTime();
+    // Sync the Alarms to current time
+    Alarms.Sync(now);
+
+    // every 5 minutes and a daily alarm at 5:30am
+    Alarms.AddAlarm(now, 5 * c_MinuteAsSeconds);
+    Alarms.AddAlarm(RtcDateTime(now.Year(), now.Month(), now.Day(), 5, 30, 0), AlarmPeriod_Daily);
+
+    attachInterrupt(digitalPinToInterrupt(RtcSquareWavePin), interruptServiceRoutine, FALLING);
+
+    Serial.println("Running...");
+}
+
+void loop () 
+{
+    Alarms.ProcessAlarms(alarmCallback, nullptr);
+
+    // hand the next alarm to the RTC, if there is time to sleep
+    if (RtcAlarmHandoff::Program(Alarms, Rtc))
+    {
+        Serial.flush();
+
+        // replace this with the deep sleep of your platform, 
+        // that will be woken by the RTC interrupt pin
+        while (!interruptFlag)
+        {
+            delay(10);
+        }
+        interruptFlag = false;
+
+        // the CPU timing may have stopped while sleeping
+        if (!RtcAlarmHandoff::Resync(Alarms, Rtc))
+        {
+            Serial.println("RTC could not be read after waking");
+        }
+        Rtc.LatchAlarmOneFlag();
+    }
+}
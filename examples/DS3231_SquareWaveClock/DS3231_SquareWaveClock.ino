@@ -0,0 +1,112 @@
+
+// CONNECTIONS:
+// DS3231 SDA --> SDA
+// DS3231 SCL --> SCL
+// DS3231 VCC --> 3.3v or 5v
+// DS3231 GND --> GND
+// SQW --->  (Pin19) Don't forget to pullup (4.7k to 10k to VCC)
+
+#include <Wire.h> // must be included here so that Arduino library object file references work
+#include <RtcDS3231.h>
+#include <RtcSquareWaveClock.h>
+
+RtcDS3231<TwoWire> Rtc(Wire);
+RtcSquareWaveClock Clock;
+
+// Interrupt Pin Lookup Table
+// (copied from Arduino Docs)
+//
+// CAUTION:  The interrupts are Arduino numbers NOT Atmel numbers
+//   and may not match (example, Mega2560 int.4 is actually Atmel Int2)
+//   this is only an issue if you plan to use the lower level interrupt features
+//
+// Board           int.0    int.1   int.2   int.3   int.4   int.5
+// ---------------------------------------------------------------
+// Uno, Ethernet    2       3
+// Mega2560         2       3       21      20     [19]      18 
+// Leonardo         3       2       0       1       7
+
+#define RtcSquareWavePin 19 // Mega2560
+#define RtcSquareWaveInterrupt 4 // Mega2560
+
+void ISR_ATTR interruptServiceRoutine()
+{
+    // the RTC changes seconds on this edge, so the clock only
+    // needs to count it
+    Clock.Tick();
+}
+
+void setup () 
+{
+    Serial.begin(115200);
+
+    // set the interrupt pin to input mode
+    pinMode(RtcSquareWavePin, INPUT);
+
+    Rtc.Begin();
+
+    RtcDateTime compiled = RtcDateTime(__DATE__, __TIME__);
+    if (!Rtc.IsDateTimeValid()) 
+    {
+        Serial.println("RTC lost confidence in the DateTime!");
+        Rtc.SetDateTime(compiled);
+    }
+
+    if (!Rtc.GetIsRunning())
+    {
+        Serial.println("RTC was not actively running, starting now");
+        Rtc.SetIsRunning(true);
+    }
+
+    // output 1Hz on the square wave pin
+    RtcSquareWaveClock::Configure(Rtc);
+
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_ARCH_MEGAAVR)
+    // for some Arduino hardware they use interrupt number for the first param
+    attachInterrupt(RtcSquareWaveInterrupt, interruptServiceRoutine, FALLING);
+#else
+    // for some Arduino hardware they use interrupt pin for the first param
+    attachInterrupt(RtcSquareWavePin, interruptServiceRoutine, FALLING);
+#endif
+
+    // read the RTC once, from now on the interrupt keeps the time
+    if (!Clock.Sync(Rtc))
+    {
+        Serial.println("RTC could not be read, check the square wave pin");
+    }
+}
+
+void loop () 
+{
+    // no bus traffic, just a read of memory
+    RtcDateTime now = Clock.Now();
+    printDateTime(now);
+    Serial.println();
+
+    // check against the RTC every hour, in case a tick was missed
+    if (Clock.SyncIfDue(Rtc, 3600))
+    {
+        Serial.println("verified with the RTC");
+    }
+
+    delay(1000);
+}
+
+#define countof(a) (sizeof(a) / sizeof(a[0]))
+
+void printDateTime(const RtcDateTime& dt)
+{
+    char datestring[26];
+
+    snprintf_P(datestring, 
+            countof(datestring),
+            PSTR("%02u/%02u/%04u %02u:%02u:%02u"),
+            dt.Month(),
+            dt.Day(),
+            dt.Year(),
+            dt.Hour(),
+            dt.Minute(),
+            dt.Second() );
+    Serial.print(datestring);
+}
+
@@ -0,0 +1,112 @@
+
+// CONNECTIONS:
+// PCF8563 SDA --> SDA
+// PCF8563 SCL --> SCL
+// PCF8563 VCC --> 3.3v or 5v
+// PCF8563 GND --> GND
+// PCF8563 INT --->  (Pin2) Don't forget to pullup (4.7k to 10k to VCC)
+
+#include <Wire.h> // must be included here so that Arduino library object file references work
+#include <RtcPCF8563.h>
+#include <RtcTimerTicks.h>
+#include <RtcAlarmManager.h>
+
+RtcPCF8563<TwoWire> Rtc(Wire);
+RtcTimerTicks Ticks;
+
+// global instance of the manager 
+RtcAlarmManager Alarms;
+
+#define RtcInterruptPin 2 // Uno
+
+void ISR_ATTR interruptServiceRoutine()
+{
+    // the timer pulses the pin, so there is no flag to 
+    // latch and the tick only needs to be counted
+    Ticks.Tick();
+}
+
+void alarmCallback([[maybe_unused]] void* context, uint8_t id, [[maybe_unused]] const RtcDateTime& alarm)
+{
+    Serial.print("ALARM: ");
+    Serial.println(id);
+}
+
+void setup () 
+{
+    Serial.begin(115200);
+
+    Serial.println("Initializing...");
+    //--------Alarms SETUP ------------
+    Alarms.Begin(1);
+
+    //--------RTC SETUP ------------
+    pinMode(RtcInterruptPin, INPUT);
+
+    Rtc.Begin();
+#if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(3000 /* us */, true /* reset_on_timeout */);
+#endif
+
+    RtcDateTime compiled = RtcDateTime(__DATE__, __TIME__);
+    if (!Rtc.IsDateTimeValid()) 
+    {
+        Serial.println("RTC lost confidence in the DateTime!");
+        Rtc.SetDateTime(compiled);
+    }
+
+    if (!Rtc.GetIsRunning())
+    {
+        Serial.println("RTC was not actively running, starting now");
+        Rtc.SetIsRunning(true);
+    }
+
+    attachInterrupt(digitalPinToInterrupt(RtcInterruptPin), interruptServiceRoutine, FALLING);
+
+    // a tick every 10 seconds, the only bus traffic from now on,
+    // started at the change of a second so Now() stays in phase
+    if (!Ticks.Start(Rtc, PCF8563TimerMode_Seconds, 10))
+    {
+        if (Rtc.LastError() != Rtc_Wire_Error_None)
+        {
+            Serial.print("RTC communications error = ");
+            Serial.println(Rtc.LastError());
+        }
+        else
+        {
+            Serial.println("RTC seconds did not change, ticks may lag a second");
+        }
+    }
+
+    RtcDateTime now = Ticks.Now();
+    Alarms.Sync(now, true);
+
+    // every minute
+    Alarms.AddAlarm(now, c_MinuteAsSeconds);
+
+    Serial.println("Running...");
+}
+
+void loop () 
+{
+    Alarms.ProcessAlarms(alarmCallback, nullptr);
+
+    Serial.flush();
+
+    // replace this with the deep sleep of your platform, 
+    // that will be woken by the RTC interrupt pin at the next tick
+    uint32_t ticksBefore = Ticks.Ticks();
+    while (Ticks.Ticks() == ticksBefore)
+    {
+        delay(10);
+    }
+
+    // the CPU timing may have stopped while sleeping, the ticks
+    // kept the time without reading the RTC, and as it was woken 
+    // by a tick it is right at the start of a second
+    uint32_t ticks = Ticks.TakeTicks();
+    Alarms.Sync(Ticks.Now(), true);
+
+    Serial.print("ticks: ");
+    Serial.println(ticks);
+}
@@ -0,0 +1,229 @@
+// These tests do not rely on RTC hardware at all
+// a simulated RTC that drifts by a known ppm for its temperature is
+// sampled against a perfect reference clock at each RTC second edge,
+// and the fitted drift and aging offset are compared to what was simulated
+
+#include <RtcAgingCalibration.h>
+
+// the reference time kept as whole microseconds, and the RTC seconds
+// that tick at the edges it is sampled at
+class SimulatedClock
+{
+public:
+    SimulatedClock() :
+        RtcSeconds(700000000),
+        _referenceUs(1000000250000LL)
+    {
+    }
+
+    // run the RTC for the given seconds at the given drift in ppm,
+    // a fast RTC reaches its seconds before the reference does
+    void Run(uint32_t seconds, float ppm)
+    {
+        RtcSeconds += seconds;
+        _referenceUs += static_cast<int64_t>(seconds) * 1000000 -
+            static_cast<int64_t>(seconds * ppm);
+    }
+
+    bool Sample(RtcAgingCalibration& calibration, int16_t centiDegC)
+    {
+        return calibration.AddSample(RtcSeconds,
+            static_cast<uint32_t>(_referenceUs / 1000000),
+            static_cast<uint32_t>(_referenceUs % 1000000),
+            RtcTemperature(centiDegC));
+    }
+
+    uint32_t RtcSeconds;
+
+protected:
+    int64_t _referenceUs;
+};
+
+// just the aging offset part of a DS3231/DS3234
+class MockAgingRtc
+{
+public:
+    MockAgingRtc() :
+        Offset(0),
+        Updates(0)
+    {
+    }
+
+    int8_t GetAgingOffset()
+    {
+        return Offset;
+    }
+
+    void SetAgingOffset(int8_t offset)
+    {
+        Offset = offset;
+    }
+
+    void ForceTemperatureCompensationUpdate(bool)
+    {
+        Updates++;
+    }
+
+    int8_t Offset;
+    uint8_t Updates;
+};
+
+void PrintPassFail(bool passed)
+{
+    if (passed)
+    {
+      Serial.print("passed");
+    }
+    else
+    {
+      Serial.print("failed");
+    }
+}
+
+void PrintlnPassFail(const char* topic, bool passed)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    PrintPassFail(passed);
+    Serial.println();
+}
+
+void ComparePrintlnPassFail(const char* topic, float value, float compare, float tolerance)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    Serial.print(value, 3);
+    Serial.print(" ");
+    PrintPassFail(fabs(value - compare) <= tolerance);
+    Serial.println();
+}
+
+void ConstantDriftTests()
+{
+    Serial.println("Constant Drift:");
+
+    SimulatedClock clock;
+    RtcAgingCalibration calibration;
+
+    PrintlnPassFail("first sample unused", !clock.Sample(calibration, 2500));
+    clock.Run(30, 2.0f);
+    PrintlnPassFail("short interval unused", !clock.Sample(calibration, 2500));
+
+    for (uint8_t hour = 0; hour < 4; hour++)
+    {
+        clock.Run(3600, 2.0f);
+        clock.Sample(calibration, 2500);
+    }
+
+    PrintlnPassFail("interval count", calibration.IntervalCount() == 4);
+    PrintlnPassFail("measured seconds", calibration.MeasuredSeconds() >= 14429 && calibration.MeasuredSeconds() <= 14430);
+    ComparePrintlnPassFail("ppm", calibration.PpmAt(RtcTemperature(2500)), 2.0f, 0.05f);
+    ComparePrintlnPassFail("no slope", calibration.PpmPerDegC(), 0.0f, 0.0f);
+    PrintlnPassFail("aging offset", calibration.OptimalAgingOffset(0, RtcTemperature(2500)) == 20);
+    PrintlnPassFail("aging offset from current", calibration.OptimalAgingOffset(-5, RtcTemperature(2500)) == 15);
+
+    Serial.println();
+}
+
+void SlowDriftTests()
+{
+    Serial.println("Slow Drift:");
+
+    SimulatedClock clock;
+    RtcAgingCalibration calibration;
+
+    clock.Sample(calibration, 2500);
+    for (uint8_t hour = 0; hour < 6; hour++)
+    {
+        clock.Run(3600, -3.5f);
+        clock.Sample(calibration, 2500);
+    }
+
+    ComparePrintlnPassFail("ppm", calibration.PpmAt(RtcTemperature(2500)), -3.5f, 0.05f);
+    PrintlnPassFail("aging offset", calibration.OptimalAgingOffset(0, RtcTemperature(2500)) == -35);
+
+    Serial.println();
+}
+
+void TemperatureSlopeTests()
+{
+    Serial.println("Temperature Slope:");
+
+    SimulatedClock clock;
+    RtcAgingCalibration calibration;
+
+    // drift of 1ppm at 25C that rises 0.2ppm for each degree,
+    // the temperature holds for each hour
+    const int16_t temperatures[] = { 2000, 2500, 3000, 3500, 3000, 2500 };
+    int16_t centiDegC = temperatures[0];
+
+    clock.Sample(calibration, centiDegC);
+    for (uint8_t index = 0; index < countof(temperatures); index++)
+    {
+        // settle the temperature before the interval starts
+        centiDegC = temperatures[index];
+        clock.Run(60, 1.0f + 0.2f * (centiDegC - 2500) / 100.0f);
+        clock.Sample(calibration, centiDegC);
+
+        clock.Run(3600, 1.0f + 0.2f * (centiDegC - 2500) / 100.0f);
+        clock.Sample(calibration, centiDegC);
+    }
+
+    ComparePrintlnPassFail("slope", calibration.PpmPerDegC(), 0.2f, 0.02f);
+    ComparePrintlnPassFail("ppm at 25C", calibration.PpmAt(RtcTemperature(2500)), 1.0f, 0.05f);
+    ComparePrintlnPassFail("ppm at 35C", calibration.PpmAt(RtcTemperature(3500)), 3.0f, 0.1f);
+    PrintlnPassFail("aging offset at 35C", calibration.OptimalAgingOffset(0, RtcTemperature(3500)) == 30);
+
+    Serial.println();
+}
+
+void ApplyTests()
+{
+    Serial.println("Apply:");
+
+    SimulatedClock clock;
+    RtcAgingCalibration calibration;
+    MockAgingRtc rtc;
+
+    PrintlnPassFail("nothing to apply", !calibration.Apply(rtc));
+
+    clock.Sample(calibration, 2500);
+    clock.Run(7200, 1.2f);
+    clock.Sample(calibration, 2500);
+
+    PrintlnPassFail("applied", calibration.Apply(rtc));
+    PrintlnPassFail("offset", rtc.Offset == 12);
+    PrintlnPassFail("compensation updated", rtc.Updates == 1);
+    PrintlnPassFail("samples reset", calibration.IntervalCount() == 0);
+
+    // the trimmed RTC now keeps time
+    clock.Sample(calibration, 2500);
+    clock.Run(7200, 0.0f);
+    clock.Sample(calibration, 2500);
+    PrintlnPassFail("already optimal", !calibration.Apply(rtc) && rtc.Offset == 12);
+
+    // beyond what the register can trim
+    calibration.Reset();
+    clock.Sample(calibration, 2500);
+    clock.Run(7200, 20.0f);
+    clock.Sample(calibration, 2500);
+    PrintlnPassFail("clamped", calibration.Apply(rtc) && rtc.Offset == INT8_MAX);
+
+    Serial.println();
+}
+
+void setup ()
+{
+    Serial.begin(115200);
+    while (!Serial);
+    Serial.println();
+
+    ConstantDriftTests();
+    SlowDriftTests();
+    TemperatureSlopeTests();
+    ApplyTests();
+}
+
+void loop ()
+{
+}
@@ -0,0 +1,339 @@
+// These tests do not rely on RTC hardware at all
+// simulated buses stand in for the devices, and a sleep is simulated by
+// moving the time of the RTC forward while millis() barely moves, then
+// the alarms programmed by RtcAlarmHandoff are checked along with the
+// Resync that follows the wake
+
+#include <RtcDS3231.h>
+#include <RtcDS3234.h>
+#include <RtcPCF8563.h>
+#include <RtcAlarmManager.h>
+#include <RtcAlarmHandoff.h>
+
+// a Wire bus with one device on it, as a register file with
+// an auto incrementing address like the RTCs use
+class MockWire
+{
+public:
+    MockWire() :
+        _address(0),
+        _addressPending(false),
+        _rxCount(0),
+        _rxIndex(0),
+        FailNext(false)
+    {
+        memset(Memory, 0, sizeof(Memory));
+    }
+
+    void begin()
+    {
+    }
+
+    void beginTransmission(uint8_t)
+    {
+        _addressPending = true;
+    }
+
+    size_t write(uint8_t value)
+    {
+        if (_addressPending)
+        {
+            _address = value;
+            _addressPending = false;
+        }
+        else
+        {
+            Memory[_address++] = value;
+        }
+        return 1;
+    }
+
+    uint8_t endTransmission(bool = true)
+    {
+        if (FailNext)
+        {
+            FailNext = false;
+            return Rtc_Wire_Error_NoAddressableDevice;
+        }
+        return Rtc_Wire_Error_None;
+    }
+
+    size_t requestFrom(uint8_t, size_t count)
+    {
+        if (count > sizeof(_rx))
+        {
+            count = sizeof(_rx);
+        }
+        for (size_t index = 0; index < count; index++)
+        {
+            _rx[index] = Memory[_address++];
+        }
+        _rxCount = count;
+        _rxIndex = 0;
+        return count;
+    }
+
+    int available()
+    {
+        return _rxCount - _rxIndex;
+    }
+
+    int read()
+    {
+        return (_rxIndex < _rxCount) ? _rx[_rxIndex++] : -1;
+    }
+
+    uint8_t Memory[256];
+
+protected:
+    uint8_t _address;
+    bool _addressPending;
+    uint8_t _rx[32];
+    size_t _rxCount;
+    size_t _rxIndex;
+
+public:
+    bool FailNext;
+};
+
+// a SPI bus with a DS3234 on it, the first byte of a transaction is
+// the register address with the write flag in the high bit
+class MockSpi
+{
+public:
+    MockSpi() :
+        _address(0),
+        _addressPending(false),
+        _write(false)
+    {
+        memset(Memory, 0, sizeof(Memory));
+    }
+
+    void begin()
+    {
+    }
+
+    void beginTransaction(const SPISettings&)
+    {
+        _addressPending = true;
+    }
+
+    void endTransaction()
+    {
+    }
+
+    uint8_t transfer(uint8_t value)
+    {
+        if (_addressPending)
+        {
+            _write = (value & 0x80);
+            _address = value & 0x7f;
+            _addressPending = false;
+            return 0;
+        }
+        if (_write)
+        {
+            Memory[_address] = value;
+        }
+        return Memory[_address++];
+    }
+
+    void transfer(void* buffer, size_t count)
+    {
+        uint8_t* pValue = static_cast<uint8_t*>(buffer);
+        for (size_t index = 0; index < count; index++)
+        {
+            pValue[index] = transfer(pValue[index]);
+        }
+    }
+
+    uint8_t Memory[128];
+
+protected:
+    uint8_t _address;
+    bool _addressPending;
+    bool _write;
+};
+
+void PrintPassFail(bool passed)
+{
+    if (passed)
+    {
+      Serial.print("passed");
+    }
+    else
+    {
+      Serial.print("failed");
+    }
+}
+
+void PrintlnPassFail(const char* topic, bool passed)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    PrintPassFail(passed);
+    Serial.println();
+}
+
+// counts the alarms that triggered and the last id
+struct AlarmLog
+{
+    uint8_t Count;
+    uint8_t Id;
+};
+
+void alarmCallback(void* context, uint8_t id, [[maybe_unused]] const RtcDateTime& alarm)
+{
+    AlarmLog* log = static_cast<AlarmLog*>(context);
+    log->Count++;
+    log->Id = id;
+}
+
+const RtcDateTime Start(2024, 5, 17, 23, 59, 0);
+
+void DS3231Tests()
+{
+    Serial.println("DS3231:");
+
+    MockWire wire;
+    RtcDS3231<MockWire> rtc(wire);
+    RtcAlarmManager alarms;
+    AlarmLog log = { 0, 0 };
+    int32_t delta = 0;
+
+    rtc.Begin();
+    rtc.SetDateTime(Start);
+    alarms.Begin(2);
+    alarms.Sync(rtc.GetDateTime());
+
+    PrintlnPassFail("no alarm no sleep", !RtcAlarmHandoff::Program(alarms, rtc));
+
+    int8_t soon = alarms.AddAlarm(Start + 1, AlarmPeriod_SingleFire);
+    PrintlnPassFail("due alarm no sleep", !RtcAlarmHandoff::Program(alarms, rtc));
+    alarms.RemoveAlarm(soon);
+
+    // crosses midnight, so the day of month must move too
+    int8_t id = alarms.AddAlarm(Start + 90, AlarmPeriod_Daily);
+    wire.Memory[DS3231_REG_STATUS] |= _BV(DS3231_A1F);
+    PrintlnPassFail("programmed", RtcAlarmHandoff::Program(alarms, rtc));
+
+    DS3231AlarmOne alarm = rtc.GetAlarmOne();
+    PrintlnPassFail("alarm day", alarm.DayOf() == 18);
+    PrintlnPassFail("alarm time", alarm.Hour() == 0 && alarm.Minute() == 0 && alarm.Second() == 30);
+    PrintlnPassFail("alarm match", alarm.ControlFlags() == DS3231AlarmOneControl_HoursMinutesSecondsDayOfMonthMatch);
+    PrintlnPassFail("flag latched", !(wire.Memory[DS3231_REG_STATUS] & _BV(DS3231_A1F)));
+
+    // sleep until the alarm, millis() hardly moved
+    rtc.SetDateTime(Start + 90);
+    PrintlnPassFail("resync", RtcAlarmHandoff::Resync(alarms, rtc, &delta));
+    PrintlnPassFail("resync delta", delta == 90);
+    alarms.ProcessAlarms(alarmCallback, &log);
+    PrintlnPassFail("triggered once", log.Count == 1 && log.Id == id);
+
+    RtcDateTime due;
+    alarms.NextAlarmDue(&due);
+    PrintlnPassFail("next day", due == Start + 90 + c_DayAsSeconds);
+
+    wire.FailNext = true;
+    PrintlnPassFail("bus error no sleep", !RtcAlarmHandoff::Program(alarms, rtc));
+
+    // a failed read after waking must not move the alarm manager
+    rtc.SetDateTime(Start + 200);
+    wire.FailNext = true;
+    PrintlnPassFail("bus error no resync", !RtcAlarmHandoff::Resync(alarms, rtc));
+    PrintlnPassFail("time kept", alarms.Now() == Start + 90);
+
+    Serial.println();
+}
+
+void DS3234Tests()
+{
+    Serial.println("DS3234:");
+
+    MockSpi spi;
+    RtcDS3234<MockSpi> rtc(spi, 10);
+    RtcAlarmManager alarms;
+    AlarmLog log = { 0, 0 };
+    int32_t delta = 0;
+
+    rtc.Begin();
+    rtc.SetDateTime(Start);
+    alarms.Begin(1);
+    alarms.Sync(rtc.GetDateTime());
+
+    int8_t id = alarms.AddAlarm(Start + 3600, AlarmPeriod_SingleFire);
+    spi.Memory[DS3234_REG_STATUS] |= _BV(DS3234_A1F) | _BV(DS3234_A2F);
+    PrintlnPassFail("programmed", RtcAlarmHandoff::Program(alarms, rtc));
+
+    DS3234AlarmOne alarm = rtc.GetAlarmOne();
+    PrintlnPassFail("alarm day", alarm.DayOf() == 18);
+    PrintlnPassFail("alarm time", alarm.Hour() == 0 && alarm.Minute() == 59 && alarm.Second() == 0);
+    PrintlnPassFail("flags latched", !(spi.Memory[DS3234_REG_STATUS] & (_BV(DS3234_A1F) | _BV(DS3234_A2F))));
+
+    rtc.SetDateTime(Start + 3600);
+    PrintlnPassFail("resync", RtcAlarmHandoff::Resync(alarms, rtc, &delta));
+    PrintlnPassFail("resync delta", delta == 3600);
+    alarms.ProcessAlarms(alarmCallback, &log);
+    PrintlnPassFail("triggered once", log.Count == 1 && log.Id == id);
+    PrintlnPassFail("expired no sleep", !RtcAlarmHandoff::Program(alarms, rtc));
+
+    Serial.println();
+}
+
+void PCF8563Tests()
+{
+    Serial.println("PCF8563:");
+
+    MockWire wire;
+    RtcPCF8563<MockWire> rtc(wire);
+    RtcAlarmManager alarms;
+    AlarmLog log = { 0, 0 };
+    int32_t delta = 0;
+
+    rtc.Begin();
+    rtc.SetDateTime(Start + 10);
+    alarms.Begin(2);
+    alarms.Sync(rtc.GetDateTime());
+
+    // the hardware only matches minutes, so one in the same minute is due
+    int8_t same = alarms.AddAlarm(Start + 40, AlarmPeriod_SingleFire);
+    PrintlnPassFail("same minute no sleep", !RtcAlarmHandoff::Program(alarms, rtc));
+    alarms.RemoveAlarm(same);
+
+    int8_t id = alarms.AddAlarm(Start + 125, AlarmPeriod_SingleFire);
+    PrintlnPassFail("programmed", RtcAlarmHandoff::Program(alarms, rtc));
+    PrintlnPassFail("alarm minute", wire.Memory[PCF8563_REG_ALARM] == 0x01);
+    PrintlnPassFail("alarm hour", wire.Memory[PCF8563_REG_ALARM + 1] == 0x00);
+    PrintlnPassFail("alarm day", wire.Memory[PCF8563_REG_ALARM + 2] == 0x18);
+    PrintlnPassFail("day of week ignored", wire.Memory[PCF8563_REG_ALARM + 3] & 0x80);
+
+    // it wakes at the start of the minute, before the alarm is due
+    rtc.SetDateTime(Start + 120);
+    PrintlnPassFail("resync", RtcAlarmHandoff::Resync(alarms, rtc, &delta));
+    PrintlnPassFail("resync delta", delta == 110);
+    alarms.ProcessAlarms(alarmCallback, &log);
+    PrintlnPassFail("not yet triggered", log.Count == 0);
+    PrintlnPassFail("same minute no sleep again", !RtcAlarmHandoff::Program(alarms, rtc));
+
+    rtc.SetDateTime(Start + 125);
+    RtcAlarmHandoff::Resync(alarms, rtc);
+    alarms.ProcessAlarms(alarmCallback, &log);
+    PrintlnPassFail("triggered once", log.Count == 1 && log.Id == id);
+
+    Serial.println();
+}
+
+void setup ()
+{
+    Serial.begin(115200);
+    while (!Serial);
+    Serial.println();
+
+    DS3231Tests();
+    DS3234Tests();
+    PCF8563Tests();
+}
+
+void loop ()
+{
+}
@@ -0,0 +1,167 @@
+// These tests do not rely on RTC hardware at all
+// the clock of the alarm manager is moved straight to each alarm as it
+// comes due with Sync(), so hours of alarms across the daylight savings
+// transitions of US Eastern are checked in moments
+
+#include <RtcAlarmManager.h>
+
+void PrintPassFail(bool passed)
+{
+    if (passed)
+    {
+      Serial.print("passed");
+    }
+    else
+    {
+      Serial.print("failed");
+    }
+}
+
+void PrintlnPassFail(const char* topic, bool passed)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    PrintPassFail(passed);
+    Serial.println();
+}
+
+// the second Sunday of March to the first Sunday of November at 2am
+RtcTimeZoneRule Eastern(-5 * 60, 60,
+    { 3, 2, DayOfWeek_Sunday, 2 },
+    { 11, 1, DayOfWeek_Sunday, 2 });
+
+// the UTC times an alarm triggered at
+struct AlarmLog
+{
+    uint8_t Count;
+    uint32_t Seconds[16];
+};
+
+void alarmCallback(void* context, [[maybe_unused]] uint8_t id, const RtcDateTime& alarm)
+{
+    AlarmLog* log = static_cast<AlarmLog*>(context);
+    if (log->Count < countof(log->Seconds))
+    {
+        log->Seconds[log->Count] = alarm.TotalSeconds();
+    }
+    log->Count++;
+}
+
+// move the clock to each alarm as it is due until the given UTC time
+void RunUntil(RtcAlarmManager& alarms, const RtcDateTime& until, AlarmLog* log)
+{
+    RtcDateTime due;
+
+    log->Count = 0;
+    while (alarms.NextAlarmDue(&due) && due.TotalSeconds() <= until.TotalSeconds())
+    {
+        alarms.Sync(due);
+        alarms.ProcessAlarms(alarmCallback, log);
+    }
+}
+
+// all the gaps between the logged alarms are the given seconds
+bool AllGapsAre(const AlarmLog& log, uint32_t seconds)
+{
+    for (uint8_t index = 1; index < log.Count && index < countof(log.Seconds); index++)
+    {
+        if (log.Seconds[index] - log.Seconds[index - 1] != seconds)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FixedPeriodTests()
+{
+    Serial.println("Fixed Periods:");
+
+    RtcAlarmManager alarms;
+    AlarmLog log;
+
+    alarms.Begin(1);
+
+    // fall back, 1am to 2am local happens twice
+    alarms.Sync(RtcDateTime(2024, 11, 3, 5, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 11, 3, 1, 15, 0), 15 * c_MinuteAsSeconds, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 11, 3, 8, 14, 59), &log);
+    PrintlnPassFail("fall back count", log.Count == 12);
+    PrintlnPassFail("fall back first", log.Seconds[0] == RtcDateTime(2024, 11, 3, 5, 15, 0).TotalSeconds());
+    PrintlnPassFail("fall back gaps", AllGapsAre(log, 15 * c_MinuteAsSeconds));
+
+    alarms.RemoveAlarm(0);
+    alarms.Sync(RtcDateTime(2024, 11, 3, 4, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 11, 3, 0, 30, 0), AlarmPeriod_Hourly, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 11, 3, 8, 0, 0), &log);
+    PrintlnPassFail("fall back hourly count", log.Count == 4);
+    PrintlnPassFail("fall back hourly gaps", AllGapsAre(log, c_HourAsSeconds));
+
+    // spring forward, 2am to 3am local never happens
+    alarms.RemoveAlarm(0);
+    alarms.Sync(RtcDateTime(2024, 3, 10, 5, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 3, 10, 0, 15, 0), 15 * c_MinuteAsSeconds, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 3, 10, 8, 14, 59), &log);
+    PrintlnPassFail("spring forward count", log.Count == 12);
+    PrintlnPassFail("spring forward gaps", AllGapsAre(log, 15 * c_MinuteAsSeconds));
+
+    alarms.RemoveAlarm(0);
+    alarms.Sync(RtcDateTime(2024, 3, 10, 5, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 3, 10, 0, 30, 0), AlarmPeriod_Hourly, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 3, 10, 9, 0, 0), &log);
+    PrintlnPassFail("spring forward hourly count", log.Count == 4);
+    PrintlnPassFail("spring forward hourly gaps", AllGapsAre(log, c_HourAsSeconds));
+
+    Serial.println();
+}
+
+void CalendarPeriodTests()
+{
+    Serial.println("Calendar Periods:");
+
+    RtcAlarmManager alarms;
+    AlarmLog log;
+
+    alarms.Begin(1);
+
+    // 7am local stays 7am, so the day across the change is 23 hours
+    alarms.Sync(RtcDateTime(2024, 3, 9, 0, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 3, 9, 7, 0, 0), AlarmPeriod_Daily, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 3, 11, 12, 0, 0), &log);
+    PrintlnPassFail("spring forward daily count", log.Count == 3);
+    PrintlnPassFail("spring forward daily before", log.Seconds[0] == RtcDateTime(2024, 3, 9, 12, 0, 0).TotalSeconds());
+    PrintlnPassFail("spring forward daily after", log.Seconds[1] == RtcDateTime(2024, 3, 10, 11, 0, 0).TotalSeconds());
+
+    // and 25 hours when it falls back
+    alarms.RemoveAlarm(0);
+    alarms.Sync(RtcDateTime(2024, 11, 2, 0, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 11, 2, 7, 0, 0), AlarmPeriod_Daily, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 11, 4, 12, 0, 0), &log);
+    PrintlnPassFail("fall back daily count", log.Count == 3);
+    PrintlnPassFail("fall back daily before", log.Seconds[0] == RtcDateTime(2024, 11, 2, 11, 0, 0).TotalSeconds());
+    PrintlnPassFail("fall back daily after", log.Seconds[1] == RtcDateTime(2024, 11, 3, 12, 0, 0).TotalSeconds());
+
+    // weekly across both
+    alarms.RemoveAlarm(0);
+    alarms.Sync(RtcDateTime(2024, 3, 1, 0, 0, 0));
+    alarms.AddAlarm(RtcDateTime(2024, 3, 6, 9, 0, 0), AlarmPeriod_Weekly, Eastern);
+    RunUntil(alarms, RtcDateTime(2024, 3, 14, 0, 0, 0), &log);
+    PrintlnPassFail("spring forward weekly", log.Count == 2 &&
+        log.Seconds[1] == RtcDateTime(2024, 3, 13, 13, 0, 0).TotalSeconds());
+
+    Serial.println();
+}
+
+void setup ()
+{
+    Serial.begin(115200);
+    while (!Serial);
+    Serial.println();
+
+    FixedPeriodTests();
+    CalendarPeriodTests();
+}
+
+void loop ()
+{
+}
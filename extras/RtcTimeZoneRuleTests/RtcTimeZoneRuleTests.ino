@@ -0,0 +1,165 @@
+// These tests do not rely on RTC hardware at all
+// conversions around the daylight savings transitions of US Eastern
+// and a southern hemisphere zone are checked
+
+#include <RtcUtility.h>
+#include <RtcDateTime.h>
+#include <RtcTimeZoneRule.h>
+
+void PrintPassFail(bool passed)
+{
+    if (passed)
+    {
+      Serial.print("passed");
+    }
+    else
+    {
+      Serial.print("failed");
+    }
+}
+
+void PrintDateTime(const RtcDateTime& dt)
+{
+    char datestring[26];
+
+    snprintf_P(datestring,
+            countof(datestring),
+            PSTR("%02u/%02u/%04u %02u:%02u:%02u"),
+            dt.Month(),
+            dt.Day(),
+            dt.Year(),
+            dt.Hour(),
+            dt.Minute(),
+            dt.Second() );
+    Serial.print(datestring);
+}
+
+void ComparePrintlnPassFail(const char* topic, RtcDateTime result, const RtcDateTime& compare)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    PrintDateTime(result);
+    Serial.print(" ");
+    PrintPassFail(result == compare);
+    Serial.println();
+}
+
+// the second Sunday of March to the first Sunday of November at 2am
+RtcTimeZoneRule Eastern(-5 * 60, 60,
+    { 3, 2, DayOfWeek_Sunday, 2 },
+    { 11, 1, DayOfWeek_Sunday, 2 });
+
+// the first Sunday of October to the first Sunday of April at 2am,
+// with standard time at 2am and daylight time at 3am
+RtcTimeZoneRule Sydney(10 * 60, 60,
+    { 10, 1, DayOfWeek_Sunday, 2 },
+    { 4, 1, DayOfWeek_Sunday, 3 });
+
+void StandardAndDaylightTests()
+{
+    Serial.println("Standard and Daylight:");
+
+    ComparePrintlnPassFail("winter to local",
+        Eastern.ToLocal(RtcDateTime(2024, 1, 15, 17, 0, 0)),
+        RtcDateTime(2024, 1, 15, 12, 0, 0));
+    ComparePrintlnPassFail("winter to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 1, 15, 12, 0, 0)),
+        RtcDateTime(2024, 1, 15, 17, 0, 0));
+    ComparePrintlnPassFail("summer to local",
+        Eastern.ToLocal(RtcDateTime(2024, 7, 4, 16, 0, 0)),
+        RtcDateTime(2024, 7, 4, 12, 0, 0));
+    ComparePrintlnPassFail("summer to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 7, 4, 12, 0, 0)),
+        RtcDateTime(2024, 7, 4, 16, 0, 0));
+
+    Serial.println();
+}
+
+void SpringForwardTests()
+{
+    // 2am local on 2024-03-10 becomes 3am, 2am to 3am never happens
+    Serial.println("Spring Forward:");
+
+    ComparePrintlnPassFail("before gap to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 3, 10, 1, 59, 59)),
+        RtcDateTime(2024, 3, 10, 6, 59, 59));
+    ComparePrintlnPassFail("start of gap to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 3, 10, 2, 0, 0)),
+        RtcDateTime(2024, 3, 10, 7, 0, 0));
+    ComparePrintlnPassFail("in gap to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 3, 10, 2, 30, 0)),
+        RtcDateTime(2024, 3, 10, 7, 30, 0));
+    ComparePrintlnPassFail("in gap round trip",
+        Eastern.ToLocal(Eastern.ToUtc(RtcDateTime(2024, 3, 10, 2, 30, 0))),
+        RtcDateTime(2024, 3, 10, 3, 30, 0));
+    ComparePrintlnPassFail("after gap to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 3, 10, 3, 0, 0)),
+        RtcDateTime(2024, 3, 10, 7, 0, 0));
+    ComparePrintlnPassFail("transition to local",
+        Eastern.ToLocal(RtcDateTime(2024, 3, 10, 7, 0, 0)),
+        RtcDateTime(2024, 3, 10, 3, 0, 0));
+
+    Serial.println();
+}
+
+void FallBackTests()
+{
+    // 2am local on 2024-11-03 becomes 1am, 1am to 2am happens twice
+    Serial.println("Fall Back:");
+
+    ComparePrintlnPassFail("first 1:30 to local",
+        Eastern.ToLocal(RtcDateTime(2024, 11, 3, 5, 30, 0)),
+        RtcDateTime(2024, 11, 3, 1, 30, 0));
+    ComparePrintlnPassFail("second 1:30 to local",
+        Eastern.ToLocal(RtcDateTime(2024, 11, 3, 6, 30, 0)),
+        RtcDateTime(2024, 11, 3, 1, 30, 0));
+    ComparePrintlnPassFail("repeated 1:30 to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 11, 3, 1, 30, 0)),
+        RtcDateTime(2024, 11, 3, 5, 30, 0));
+    ComparePrintlnPassFail("before repeat to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 11, 3, 0, 59, 59)),
+        RtcDateTime(2024, 11, 3, 4, 59, 59));
+    ComparePrintlnPassFail("after repeat to utc",
+        Eastern.ToUtc(RtcDateTime(2024, 11, 3, 2, 0, 0)),
+        RtcDateTime(2024, 11, 3, 7, 0, 0));
+
+    Serial.println();
+}
+
+void SouthernTests()
+{
+    Serial.println("Southern:");
+
+    ComparePrintlnPassFail("summer to utc",
+        Sydney.ToUtc(RtcDateTime(2024, 1, 15, 12, 0, 0)),
+        RtcDateTime(2024, 1, 15, 1, 0, 0));
+    ComparePrintlnPassFail("winter to utc",
+        Sydney.ToUtc(RtcDateTime(2024, 7, 15, 12, 0, 0)),
+        RtcDateTime(2024, 7, 15, 2, 0, 0));
+    // 2am local on 2024-10-06 becomes 3am
+    ComparePrintlnPassFail("in gap to utc",
+        Sydney.ToUtc(RtcDateTime(2024, 10, 6, 2, 30, 0)),
+        RtcDateTime(2024, 10, 5, 16, 30, 0));
+    // 3am local on 2024-04-07 becomes 2am
+    ComparePrintlnPassFail("repeated 2:30 to utc",
+        Sydney.ToUtc(RtcDateTime(2024, 4, 7, 2, 30, 0)),
+        RtcDateTime(2024, 4, 6, 15, 30, 0));
+
+    Serial.println();
+}
+
+void setup ()
+{
+    Serial.begin(115200);
+    while (!Serial);
+    Serial.println();
+
+    StandardAndDaylightTests();
+    SpringForwardTests();
+    FallBackTests();
+    SouthernTests();
+}
+
+void loop ()
+{
+}
@@ -0,0 +1,254 @@
+// These tests do not rely on RTC hardware at all
+// a simulated Wire bus stands in for the devices, and the stepped 
+// reads of RtcWireAsyncRead are compared against the blocking reads
+
+#include <RtcDS3231.h>
+#include <RtcDS1307.h>
+#include <RtcPCF8563.h>
+#include <EepromAT24C32.h>
+
+// a Wire bus with one device on it, as a register file with 
+// an auto incrementing address like the RTCs and EEPROM use
+class MockWire
+{
+public:
+    MockWire(uint8_t addressSize = 1) :
+        _addressSize(addressSize),
+        _address(0),
+        _addressWritten(0),
+        _rxCount(0),
+        _rxIndex(0),
+        Transactions(0),
+        FailNext(false)
+    {
+        memset(Memory, 0, sizeof(Memory));
+    }
+
+    void begin()
+    {
+    }
+
+    void beginTransmission(uint8_t)
+    {
+        _addressWritten = 0;
+    }
+
+    size_t write(uint8_t value)
+    {
+        if (_addressWritten < _addressSize)
+        {
+            _address = (_address << 8) | value;
+            _addressWritten++;
+            if (_addressWritten == _addressSize)
+            {
+                _address %= sizeof(Memory);
+            }
+        }
+        else
+        {
+            Memory[_address] = value;
+            _address = (_address + 1) % sizeof(Memory);
+        }
+        return 1;
+    }
+
+    uint8_t endTransmission(bool = true)
+    {
+        Transactions++;
+        if (FailNext)
+        {
+            FailNext = false;
+            return Rtc_Wire_Error_NoAddressableDevice;
+        }
+        return Rtc_Wire_Error_None;
+    }
+
+    size_t requestFrom(uint8_t, size_t count)
+    {
+        Transactions++;
+        if (count > sizeof(_rx))
+        {
+            count = sizeof(_rx);
+        }
+        for (size_t index = 0; index < count; index++)
+        {
+            _rx[index] = Memory[_address];
+            _address = (_address + 1) % sizeof(Memory);
+        }
+        _rxCount = count;
+        _rxIndex = 0;
+        return count;
+    }
+
+    int available()
+    {
+        return _rxCount - _rxIndex;
+    }
+
+    int read()
+    {
+        return (_rxIndex < _rxCount) ? _rx[_rxIndex++] : -1;
+    }
+
+    uint8_t Memory[256];
+
+protected:
+    uint8_t _addressSize;
+    uint16_t _address;
+    uint8_t _addressWritten;
+    uint8_t _rx[32];
+    size_t _rxCount;
+    size_t _rxIndex;
+
+public:
+    int Transactions;
+    bool FailNext;
+};
+
+void PrintPassFail(bool passed)
+{
+    if (passed)
+    {
+      Serial.print("passed");
+    }
+    else
+    {
+      Serial.print("failed");
+    }
+}
+
+void PrintlnPassFail(const char* topic, bool passed)
+{
+    Serial.print(topic);
+    Serial.print(" ");
+    PrintPassFail(passed);
+    Serial.println();
+}
+
+// poll a request to completion, counting the steps it took
+template<class T_REQUEST> uint8_t PollToEnd(T_REQUEST& request)
+{
+    uint8_t steps = 0;
+    while (request.IsBusy() && steps < 10)
+    {
+        request.Poll();
+        steps++;
+    }
+    return steps;
+}
+
+void DS3231Tests()
+{
+    Serial.println("DS3231:");
+
+    MockWire wire;
+    RtcDS3231<MockWire> rtc(wire);
+    RtcWireAsyncRead<MockWire> request(wire);
+
+    rtc.SetDateTime(RtcDateTime(2031, 12, 31, 23, 59, 58));
+    RtcDateTime blocking = rtc.GetDateTime();
+
+    PrintlnPassFail("start", rtc.StartGetDateTime(request));
+    PrintlnPassFail("busy start refused", !rtc.StartGetDateTime(request));
+    PrintlnPassFail("two steps", PollToEnd(request) == 2);
+    PrintlnPassFail("complete", request.State() == RtcAsyncState_Complete);
+    PrintlnPassFail("date time matches", rtc.GetDateTime(request) == blocking);
+
+    // 25.25C
+    wire.Memory[DS3231_REG_TEMP] = 0x19;
+    wire.Memory[DS3231_REG_TEMP + 1] = 0x40;
+    RtcTemperature temperature = rtc.GetTemperature();
+
+    rtc.StartGetTemperature(request);
+    PollToEnd(request);
+    PrintlnPassFail("temperature matches", rtc.GetTemperature(request) == temperature);
+
+    wire.FailNext = true;
+    rtc.StartGetDateTime(request);
+    PollToEnd(request);
+    PrintlnPassFail("error state", request.State() == RtcAsyncState_Error);
+    rtc.GetDateTime(request);
+    PrintlnPassFail("error reported", rtc.LastError() == Rtc_Wire_Error_NoAddressableDevice);
+
+    Serial.println();
+}
+
+void DS1307Tests()
+{
+    Serial.println("DS1307:");
+
+    MockWire wire;
+    RtcDS1307<MockWire> rtc(wire);
+    RtcWireAsyncRead<MockWire> request(wire);
+
+    rtc.SetDateTime(RtcDateTime(2024, 2, 29, 12, 34, 56));
+    RtcDateTime blocking = rtc.GetDateTime();
+
+    rtc.StartGetDateTime(request);
+    PollToEnd(request);
+    PrintlnPassFail("date time matches", rtc.GetDateTime(request) == blocking);
+
+    Serial.println();
+}
+
+void PCF8563Tests()
+{
+    Serial.println("PCF8563:");
+
+    MockWire wire;
+    RtcPCF8563<MockWire> rtc(wire);
+    RtcWireAsyncRead<MockWire> request(wire);
+
+    rtc.SetDateTime(RtcDateTime(2099, 6, 15, 1, 2, 3));
+    RtcDateTime blocking = rtc.GetDateTime();
+
+    rtc.StartGetDateTime(request);
+    PollToEnd(request);
+    PrintlnPassFail("date time matches", rtc.GetDateTime(request) == blocking);
+
+    Serial.println();
+}
+
+void EepromTests()
+{
+    Serial.println("AT24C32:");
+
+    MockWire wire(2);
+    EepromAt24c32<MockWire> eeprom(wire);
+    RtcWireAsyncRead<MockWire, 16> request(wire);
+
+    for (uint8_t index = 0; index < 16; index++)
+    {
+        wire.Memory[0x40 + index] = index * 7;
+    }
+
+    uint8_t blocking[16];
+    uint8_t stepped[16];
+
+    eeprom.GetMemory(0x40, blocking, sizeof(blocking));
+    PrintlnPassFail("blocking read", blocking[15] == 15 * 7);
+
+    PrintlnPassFail("too large refused", !eeprom.StartGetMemory(request, 0x40, 17));
+    eeprom.StartGetMemory(request, 0x40, sizeof(stepped));
+    PollToEnd(request);
+    PrintlnPassFail("count", eeprom.GetMemory(request, stepped, sizeof(stepped)) == sizeof(stepped));
+    PrintlnPassFail("memory matches", memcmp(blocking, stepped, sizeof(stepped)) == 0);
+
+    Serial.println();
+}
+
+void setup () 
+{
+    Serial.begin(115200);
+    while (!Serial);
+    Serial.println();
+
+    DS3231Tests();
+    DS1307Tests();
+    PCF8563Tests();
+    EepromTests();
+}
+
+void loop () 
+{
+}
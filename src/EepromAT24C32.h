@@ -25,6 +25,8 @@ License along with Rtc.  If not, see
 -------------------------------------------------------------------------*/
 
 #include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcWireAsyncRead.h"
 
 #pragma once
 
@@ -130,6 +132,40 @@ public:
         return countRead;
     }
 
+    // start reading memory in steps, 
+    // call request.Poll() until it completes, see RtcWireAsyncRead
+    // return - false if the request is busy or countBytes is more than it holds
+    template<uint8_t V_SIZE> bool StartGetMemory(RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request,
+        uint16_t memoryAddress,
+        uint8_t countBytes)
+    {
+        return request.Start(_address, memoryAddress, countBytes, 2);
+    }
+
+    // copy the memory from a completed StartGetMemory() request
+    // return - the count of bytes copied
+    template<uint8_t V_SIZE> uint8_t GetMemory(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request,
+        uint8_t* pValue,
+        uint8_t countBytes)
+    {
+        _lastError = request.LastError();
+        if (request.State() != RtcAsyncState_Complete)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                _lastError = Rtc_Wire_Error_Unspecific;
+            }
+            return 0;
+        }
+
+        if (countBytes > request.Count())
+        {
+            countBytes = request.Count();
+        }
+        memcpy(pValue, request.Data(), countBytes);
+        return countBytes;
+    }
+
 private:
     const uint8_t _address;
     
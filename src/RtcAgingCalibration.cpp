@@ -0,0 +1,167 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcTemperature.h"
+#include "RtcAgingCalibration.h"
+
+void RtcAgingCalibration::Reset()
+{
+    _hasLast = false;
+    _lastRtcSeconds = 0;
+    _lastReferenceSeconds = 0;
+    _lastReferenceMicroseconds = 0;
+    _lastCentiDegC = 0;
+
+    _intervalCount = 0;
+    _sumWeight = 0.0f;
+    _sumDegC = 0.0f;
+    _sumPpm = 0.0f;
+    _sumDegCSquared = 0.0f;
+    _sumDegCPpm = 0.0f;
+    _minCentiDegC = INT16_MAX;
+    _maxCentiDegC = INT16_MIN;
+}
+
+bool RtcAgingCalibration::AddSample(uint32_t rtcSeconds,
+    uint32_t referenceSeconds,
+    uint32_t referenceMicroseconds,
+    RtcTemperature temperature)
+{
+    int16_t centiDegC = temperature.AsCentiDegC();
+    uint32_t referenceElapsed = referenceSeconds - _lastReferenceSeconds;
+
+    if (_hasLast && referenceElapsed < c_AgingCalibrationMinIntervalSeconds)
+    {
+        // too short, keep the earlier sample as the start
+        return false;
+    }
+
+    bool used = false;
+
+    if (_hasLast)
+    {
+        // the drift in microseconds over the interval, divided by the
+        // seconds of the interval, is the drift in ppm
+        int32_t rtcElapsed = rtcSeconds - _lastRtcSeconds;
+        int64_t driftUs = static_cast<int64_t>(rtcElapsed - static_cast<int32_t>(referenceElapsed)) * 1000000 -
+            (static_cast<int32_t>(referenceMicroseconds) - static_cast<int32_t>(_lastReferenceMicroseconds));
+        float seconds = referenceElapsed +
+            (static_cast<int32_t>(referenceMicroseconds) - static_cast<int32_t>(_lastReferenceMicroseconds)) / 1000000.0f;
+
+        if (seconds > 0.0f)
+        {
+            float ppm = driftUs / seconds;
+            // the temperature over the interval as the average of its ends
+            int16_t intervalCentiDegC = (static_cast<int32_t>(centiDegC) + _lastCentiDegC) / 2;
+            // relative to 25C to keep the float sums precise
+            float degC = (intervalCentiDegC - 2500) / 100.0f;
+
+            _sumWeight += seconds;
+            _sumDegC += seconds * degC;
+            _sumPpm += seconds * ppm;
+            _sumDegCSquared += seconds * degC * degC;
+            _sumDegCPpm += seconds * degC * ppm;
+
+            if (intervalCentiDegC < _minCentiDegC)
+            {
+                _minCentiDegC = intervalCentiDegC;
+            }
+            if (intervalCentiDegC > _maxCentiDegC)
+            {
+                _maxCentiDegC = intervalCentiDegC;
+            }
+
+            _intervalCount++;
+            used = true;
+        }
+    }
+
+    _hasLast = true;
+    _lastRtcSeconds = rtcSeconds;
+    _lastReferenceSeconds = referenceSeconds;
+    _lastReferenceMicroseconds = referenceMicroseconds;
+    _lastCentiDegC = centiDegC;
+
+    return used;
+}
+
+RtcTemperature RtcAgingCalibration::AverageTemperature() const
+{
+    if (_sumWeight <= 0.0f)
+    {
+        return RtcTemperature(_lastCentiDegC);
+    }
+    return RtcTemperature(static_cast<int16_t>(_sumDegC / _sumWeight * 100.0f) + 2500);
+}
+
+float RtcAgingCalibration::PpmPerDegC() const
+{
+    if (_intervalCount < 2 ||
+        (_maxCentiDegC - _minCentiDegC) < c_AgingCalibrationMinSpanCentiDegC)
+    {
+        return 0.0f;
+    }
+
+    // the weighted variance and covariance
+    float meanDegC = _sumDegC / _sumWeight;
+    float variance = _sumDegCSquared / _sumWeight - meanDegC * meanDegC;
+    if (variance <= 0.0f)
+    {
+        return 0.0f;
+    }
+    float covariance = _sumDegCPpm / _sumWeight - meanDegC * (_sumPpm / _sumWeight);
+    return covariance / variance;
+}
+
+float RtcAgingCalibration::PpmAt(RtcTemperature temperature) const
+{
+    if (_sumWeight <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float meanDegC = _sumDegC / _sumWeight;
+    float meanPpm = _sumPpm / _sumWeight;
+    return meanPpm + PpmPerDegC() * (temperature.AsFloatDegC() - 25.0f - meanDegC);
+}
+
+int8_t RtcAgingCalibration::OptimalAgingOffset(int8_t currentOffset, RtcTemperature temperature) const
+{
+    float steps = PpmAt(temperature) / c_AgingOffsetPpmPerLsb;
+    int32_t offset = currentOffset + static_cast<int32_t>(steps + (steps < 0.0f ? -0.5f : 0.5f));
+
+    if (offset > INT8_MAX)
+    {
+        offset = INT8_MAX;
+    }
+    else if (offset < INT8_MIN)
+    {
+        offset = INT8_MIN;
+    }
+    return static_cast<int8_t>(offset);
+}
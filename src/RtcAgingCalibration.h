@@ -0,0 +1,157 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcTemperature.h"
+
+// the approximate change in ppm for each step of the aging offset register
+// of the DS3231/DS3234 at 25C, a positive aging offset slows the clock
+const float c_AgingOffsetPpmPerLsb = 0.1f;
+
+// intervals shorter than this are ignored as the reference jitter
+// would dominate the measured drift
+const uint32_t c_AgingCalibrationMinIntervalSeconds = 60;
+
+// temperature spans smaller than this don't fit a usable slope
+const int16_t c_AgingCalibrationMinSpanCentiDegC = 200;
+
+// Measures the drift of a DS3231/DS3234 against a reference clock, 
+// like a GPS PPS, NTP, or a host supplied time, fits the drift in ppm 
+// against the temperature, and calculates the aging offset that trims it out
+//
+// Samples should be taken at the start of an RTC second, see RtcSecondEdge,
+// along with the reference time at that same moment.  The longer the time 
+// between samples the more accurate the result; a few hours across
+// the normal temperature range works well.
+//
+// Sample...
+//    RtcDateTime now;
+//    RtcSecondEdge::GetDateTime(Rtc, &now);
+//    calibration.AddSample(now.TotalSeconds(), 
+//        gpsSeconds, 
+//        gpsMicroseconds, 
+//        Rtc.GetTemperature());
+//    ...
+//    calibration.Apply(Rtc);
+//
+class RtcAgingCalibration
+{
+public:
+    RtcAgingCalibration()
+    {
+        Reset();
+    }
+
+    // throw away all samples, required when the aging offset is changed
+    // outside of Apply()
+    void Reset();
+
+    // rtcSeconds - the RTC time, as from RtcDateTime.TotalSeconds(), taken 
+    //     at the start of the RTC second
+    // referenceSeconds, referenceMicroseconds - the reference time at the 
+    //     same moment, its epoch doesn't matter but it must not change
+    // temperature - as from GetTemperature()
+    // returns - true if the interval from the last sample was used
+    bool AddSample(uint32_t rtcSeconds,
+        uint32_t referenceSeconds,
+        uint32_t referenceMicroseconds,
+        RtcTemperature temperature);
+
+    // the number of intervals that are in the fit
+    uint16_t IntervalCount() const
+    {
+        return _intervalCount;
+    }
+
+    // the total seconds of reference time that are in the fit
+    uint32_t MeasuredSeconds() const
+    {
+        return static_cast<uint32_t>(_sumWeight);
+    }
+
+    // the average temperature across all intervals
+    RtcTemperature AverageTemperature() const;
+
+    // the fitted change in drift for each degree C, zero 
+    // until the samples span enough temperature to fit it
+    float PpmPerDegC() const;
+
+    // the fitted drift at the given temperature, positive when the RTC 
+    // runs fast compared to the reference
+    float PpmAt(RtcTemperature temperature) const;
+
+    // the aging offset that will trim out the drift at the given temperature
+    // currentOffset - the aging offset the samples were measured with
+    int8_t OptimalAgingOffset(int8_t currentOffset, RtcTemperature temperature) const;
+
+    // write the optimal aging offset for the average temperature
+    // to the RTC and start a new calibration, as any existing samples 
+    // are not valid with the new offset
+    // returns - true if the aging offset was changed
+    template <typename T_RTC> bool Apply(T_RTC& rtc)
+    {
+        if (_intervalCount == 0)
+        {
+            return false;
+        }
+
+        int8_t current = rtc.GetAgingOffset();
+        int8_t optimal = OptimalAgingOffset(current, AverageTemperature());
+
+        if (optimal == current)
+        {
+            return false;
+        }
+
+        rtc.SetAgingOffset(optimal);
+        // a temperature conversion applies the new offset right away
+        rtc.ForceTemperatureCompensationUpdate(false);
+        Reset();
+        return true;
+    }
+
+protected:
+    bool _hasLast;
+    uint32_t _lastRtcSeconds;
+    uint32_t _lastReferenceSeconds;
+    uint32_t _lastReferenceMicroseconds;
+    int16_t _lastCentiDegC;
+
+    uint16_t _intervalCount;
+
+    // sums for a least squares fit of ppm against degrees C from 25C,
+    // weighted by the length of each interval
+    float _sumWeight;
+    float _sumDegC;
+    float _sumPpm;
+    float _sumDegCSquared;
+    float _sumDegCPpm;
+    int16_t _minCentiDegC;
+    int16_t _maxCentiDegC;
+};
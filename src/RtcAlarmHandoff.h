@@ -0,0 +1,187 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+#include "RtcAlarmManager.h"
+#include "RtcDS3231.h"
+#include "RtcDS3234.h"
+#include "RtcPCF8563.h"
+
+// Hands the next alarm of a RtcAlarmManager to the hardware alarm of a 
+// RTC module so the sketch can deep sleep until the RTC interrupt pin
+// wakes it, rather than calling ProcessAlarms() continuously
+//
+// Typical use...
+//    if (RtcAlarmHandoff::Program(Alarms, Rtc))
+//    {
+//        // sleep until the RTC interrupt pin wakes us
+//        RtcAlarmHandoff::Resync(Alarms, Rtc);
+//        // then latch the alarm flag on the RTC
+//    }
+//    Alarms.ProcessAlarms(alarmCallback, context);
+//
+// NOTE: The RTC interrupt pin must already be configured to signal
+// the alarm, like SetSquareWavePin(DS3231SquareWavePin_ModeAlarmOne)
+//
+class RtcAlarmHandoff
+{
+public:
+    // program the next alarm into alarm one of the DS3231 (or DS3232)
+    // return - false if there is no active alarm or it is already due,
+    //     in which case do not sleep
+    //
+    // NOTE: Alarms further than a month out may wake early as the 
+    // day of month is all that is matched, just Resync() and Program() again
+    template<class T_WIRE_METHOD> static bool Program(RtcAlarmManager& alarms,
+        RtcDS3231<T_WIRE_METHOD>& rtc)
+    {
+        RtcDateTime due;
+
+        if (!nextAlarmDue(alarms, &due))
+        {
+            return false;
+        }
+
+        DS3231AlarmOne alarm(due.Day(),
+            due.Hour(),
+            due.Minute(),
+            due.Second(),
+            DS3231AlarmOneControl_HoursMinutesSecondsDayOfMonthMatch);
+        rtc.SetAlarmOne(alarm);
+        if (rtc.LastError() != Rtc_Wire_Error_None)
+        {
+            return false;
+        }
+        rtc.LatchAlarmOneFlag();
+
+        return (rtc.LastError() == Rtc_Wire_Error_None);
+    }
+
+    // program the next alarm into alarm one of the DS3234
+    // return - false if there is no active alarm or it is already due,
+    //     in which case do not sleep
+    //
+    // NOTE: Alarms further than a month out may wake early as the 
+    // day of month is all that is matched, just Resync() and Program() again
+    // NOTE: This will also clear the alarm two triggered flag
+    template<class T_SPI_METHOD> static bool Program(RtcAlarmManager& alarms,
+        RtcDS3234<T_SPI_METHOD>& rtc)
+    {
+        RtcDateTime due;
+
+        if (!nextAlarmDue(alarms, &due))
+        {
+            return false;
+        }
+
+        DS3234AlarmOne alarm(due.Day(),
+            due.Hour(),
+            due.Minute(),
+            due.Second(),
+            DS3234AlarmOneControl_HoursMinutesSecondsDayOfMonthMatch);
+        rtc.SetAlarmOne(alarm);
+        rtc.LatchAlarmsTriggeredFlags();
+
+        // SPI doesn't report errors, but checked like the others so a 
+        // future bus that does is not missed
+        return (rtc.LastError() == Rtc_Wire_Error_None);
+    }
+
+    // program the next alarm into the PCF8563 alarm
+    // return - false if there is no active alarm or it is already due 
+    //     within the current minute, in which case do not sleep
+    //
+    // NOTE: The PCF8563 alarm only has minute resolution, so it will wake 
+    // at the start of the minute that the next alarm is due in
+    template<class T_WIRE_METHOD> static bool Program(RtcAlarmManager& alarms,
+        RtcPCF8563<T_WIRE_METHOD>& rtc)
+    {
+        RtcDateTime due;
+
+        if (!nextAlarmDue(alarms, &due))
+        {
+            return false;
+        }
+
+        // the alarm will not trigger for the minute we are already in 
+        RtcDateTime now = alarms.Now();
+        if (due.TotalSeconds() / 60 <= now.TotalSeconds() / 60)
+        {
+            return false;
+        }
+
+        PCF8563Alarm alarm(due.Day(),
+            due.Hour(),
+            due.Minute(),
+            due.DayOfWeek(),
+            PCF8563AlarmControl_MinuteMatch | 
+                PCF8563AlarmControl_HourMatch | 
+                PCF8563AlarmControl_DayOfMonthMatch);
+        rtc.SetAlarm(alarm);
+
+        return (rtc.LastError() == Rtc_Wire_Error_None);
+    }
+
+    // sync the alarm manager to the RTC after waking, as the CPU timing
+    // that the alarm manager relies on is often stopped in deep sleep
+    // delta - [out] optional, the delta seconds, see RtcAlarmManager::Sync()
+    // return - false if the RTC could not be read, the alarm manager
+    //     is left unchanged
+    template<class T_RTC> static bool Resync(RtcAlarmManager& alarms, 
+        T_RTC& rtc,
+        int32_t* delta = nullptr)
+    {
+        RtcDateTime now = rtc.GetDateTime();
+        if (rtc.LastError() != Rtc_Wire_Error_None)
+        {
+            return false;
+        }
+
+        int32_t correction = alarms.Sync(now);
+        if (delta)
+        {
+            *delta = correction;
+        }
+        return true;
+    }
+
+private:
+    static bool nextAlarmDue(RtcAlarmManager& alarms, RtcDateTime* due)
+    {
+        if (!alarms.NextAlarmDue(due))
+        {
+            return false;
+        }
+
+        // an alarm that is due, or so close that it may pass while the
+        // RTC is being programmed, needs processing, not sleeping
+        return (due->TotalSeconds() > alarms.Now().TotalSeconds() + 1);
+    }
+};
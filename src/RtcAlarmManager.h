@@ -29,10 +29,13 @@ License along with Rtc.  If not, see
 #include <Arduino.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCronSchedule.h"
+#include "RtcTimeZoneRule.h"
 
 #if defined(RTC_NO_STL)
 
 typedef void(*RtcAlarmCallback)(void* context, uint8_t id, const RtcDateTime& alarm);
+typedef void(*RtcAlarmCoalescedCallback)(void* context, uint8_t id, const RtcDateTime& alarm, uint32_t missed);
 
 #else
 
@@ -40,6 +43,7 @@ typedef void(*RtcAlarmCallback)(void* context, uint8_t id, const RtcDateTime& al
 #undef min
 #include <functional>
 typedef std::function<void(void* context, uint8_t id, const RtcDateTime& alarm)> RtcAlarmCallback;
+typedef std::function<void(void* context, uint8_t id, const RtcDateTime& alarm, uint32_t missed)> RtcAlarmCoalescedCallback;
 
 #endif
 
@@ -58,9 +62,77 @@ enum AlarmPeriod
     AlarmPeriod_Monthly_29th, // last of month if days less than, 
     AlarmPeriod_Monthly_30th, // otherwise the day of month matching,
     AlarmPeriod_Monthly_31st, // this will be set internally, just use monthly
+    AlarmPeriod_Schedule, // set internally when a RtcCronSchedule is added
     AlarmPeriod_StartOfSpecifics = 60 // anything over this is considered a specific time in seconds
 };
 
+// internal use only, marks the period of an alarm as milliseconds
+// rather than seconds, see AddAlarmMs()
+const uint32_t c_AlarmPeriodMsFlag = 0x80000000;
+
+// the number of alarms that can be waiting in the queue from
+// QueueAlarmMs() and QueueRemoveAlarm() until ProcessAlarms() is called, 
+// define as 0 before including to remove the queue
+#if !defined(RTC_ALARM_QUEUE_SIZE)
+#define RTC_ALARM_QUEUE_SIZE 4
+#endif
+
+// the longest delay QueueAlarmMs() accepts, a day, so the delay plus the
+// time the alarm waits in the queue still fits the signed milliseconds
+// it is added as, use AddAlarm() outside of an ISR for longer
+const uint32_t c_AlarmQueueMaxMs = c_DayAsSeconds * 1000;
+
+// the span of time between calls to Sync() before the drift of 
+// millis() is estimated and applied, longer spans are more accurate
+// a whole second time read at any point within the second is off by up
+// to a second, which over a day is still under 12ppm
+const uint32_t c_AlarmDriftMinSpan = c_DayAsSeconds;
+// when both ends of the span were synced at the start of a second, 
+// see RtcSecondEdge, the error is only milliseconds so an hour is enough
+const uint32_t c_AlarmDriftMinSpanAtEdge = c_HourAsSeconds;
+// larger measured drifts are considered changes in time, not drift
+const int32_t c_AlarmDriftMaxPpm = 50000;
+
+// the bytes of memory used by RtcAlarmManager::SaveAlarms(), 
+// a header followed by an entry for each alarm
+const uint8_t c_AlarmStoreHeaderSize = 8;
+const uint8_t c_AlarmStoreEntrySize = 8;
+
+#if defined(RTC_ALARM_STATISTICS)
+// define RTC_ALARM_STATISTICS before including to collect the timing of
+// ProcessAlarms() and how late alarms trigger, see RtcAlarmManager::Statistics()
+
+// lateness is counted in buckets doubling in milliseconds,
+// 0, 1, 2-3, 4-7, ... with the last being 16384 and over
+const uint8_t c_AlarmLatenessBuckets = 16;
+
+struct RtcAlarmStatistics
+{
+    uint32_t ProcessCount; // calls to process alarms
+    uint32_t IntervalMaxMs; // longest time between calls
+    uint32_t DurationMaxUs; // longest call, including callbacks
+    uint32_t DurationTotalUs; // all calls, divide by ProcessCount for average
+    uint32_t SecondsSkipped; // whole seconds that passed without a call
+    uint32_t LatenessCounts[c_AlarmLatenessBuckets]; // triggered alarms by lateness
+
+    void Reset()
+    {
+        memset(this, 0, sizeof(*this));
+    }
+
+    static uint8_t LatenessBucket(uint32_t latenessMs)
+    {
+        uint8_t bucket = 0;
+        while (latenessMs != 0 && bucket < c_AlarmLatenessBuckets - 1)
+        {
+            latenessMs >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+};
+#endif
+
 enum AlarmAddError
 {
     AlarmAddError_PeriodInvalid = -4,
@@ -90,8 +162,28 @@ public:
     RtcAlarmManager() :
         _alarms(nullptr),
         _alarmsCount(0),
+        _alarmsReserved(0),
+        _msAlarmsCount(0),
         _msLast(0),
-        _seconds(0)
+        _seconds(0),
+        _driftPpm(0),
+        _driftLearned(false),
+        _staggerSeconds(0),
+        _secondsSyncRef(0),
+        _syncRefAtEdge(false),
+        _msSyncLast(0),
+        _msSyncSpan(0),
+        _checkPending(false)
+#if defined(RTC_ALARM_STATISTICS)
+        ,
+        _msLastProcess(0),
+        _statistics()
+#endif
+#if RTC_ALARM_QUEUE_SIZE > 0
+        ,
+        _queueHead(0),
+        _queueTail(0)
+#endif
     {
     }
 
@@ -104,8 +196,13 @@ public:
         delete[] _alarms;
     }
 
-    void Begin(uint8_t count)
+    // count - the max alarms that can be active
+    // countReserved - the count of ids starting at zero that are reserved
+    //     for QueueAlarmMs() and will not be used by AddAlarm()
+    void Begin(uint8_t count, uint8_t countReserved = 0)
     {
+        _alarmsReserved = countReserved;
+
         if (count > _alarmsCount)
         {
             _alarmsCount = count;
@@ -116,6 +213,7 @@ public:
             Serial.print((uint32_t)_alarms, HEX);
             Serial.println(")");
 
+            _msAlarmsCount = 0;
             _msLast = millis();
             _seconds = 0;
         }
@@ -148,17 +246,89 @@ public:
     // a RTC module
     // Do this at regular intervals as the internal CPU timing
     // is not very accurate
-    int32_t Sync(const RtcDateTime& now)
+    // Successive calls are used to estimate the drift of the CPU 
+    // timing which is then compensated for, so over time this can 
+    // be called less often, see DriftPpm()
+    // atSecondEdge - true when now was read just as the second started,
+    //     like from RtcSecondEdge::GetDateTime(), which makes the sync and
+    //     the drift estimate accurate to the millisecond
+    int32_t Sync(const RtcDateTime& now, bool atSecondEdge = false)
     {
         uint32_t msNow = millis();
         uint32_t secondsNow = now.TotalSeconds();
+        uint32_t msElapsed = elapsedMs(msNow);
         // calc an updated seconds for old information
-        uint32_t secondsOld = _seconds + (msNow - _msLast) / 1000;
-        // set new seconds and start tracking the millis
-        _msLast = msNow;
+        uint32_t secondsOld = _seconds + msElapsed / 1000;
+        int32_t delta = secondsNow - secondsOld;
+
+        updateDrift(msNow, secondsNow, atSecondEdge);
+
+        // alarms that became due by moving forward, like after waking
+        // from sleep, are checked on the next process even though 
+        // millis() has not passed a second
+        if (delta > 0)
+        {
+            _checkPending = true;
+        }
+
+        // set new seconds and start tracking the millis,
+        // retaining the fractional second if still within the same
+        // second as the trusted source, otherwise the nearest 
+        // edge of that second
         _seconds = secondsNow;
+        if (atSecondEdge)
+        {
+            _msLast = msNow;
+        }
+        else if (delta == 0)
+        {
+            _msLast = msNow - rawMs(msElapsed % 1000);
+        }
+        else if (delta > 0)
+        {
+            _msLast = msNow;
+        }
+        else
+        {
+            _msLast = msNow - rawMs(999);
+        }
+
         // return the delta from new seconds from old seconds
-        return (secondsNow - secondsOld);
+        return delta;
+    }
+
+    // the estimated error of the CPU timing in parts per million,
+    // positive when it runs fast
+    // this is learned from successive calls to Sync()
+    int32_t DriftPpm() const
+    {
+        return _driftPpm;
+    }
+
+    // restore a previously learned drift, like after a reboot,
+    // it will continue to be refined by calls to Sync()
+    void SetDriftPpm(int32_t ppm)
+    {
+        _driftPpm = ppm;
+        _driftLearned = true;
+    }
+
+    // spread repeating alarms of many devices across a window of time
+    // so they don't all trigger in the same second, like when they all
+    // contact a server hourly
+    // each device gets a fixed offset from its id that is added to the
+    // when of hourly, daily, weekly and specific seconds alarms added 
+    // after this call, monthly and yearly alarms are not offset
+    // deviceId - a value unique to the device, like a serial number
+    // windowSeconds - the offsets will be from 0 up to this, 0 disables,
+    //     keep it less than the shortest period used
+    void SetStagger(uint32_t deviceId, uint32_t windowSeconds)
+    {
+        _staggerSeconds = 0;
+        if (windowSeconds)
+        {
+            _staggerSeconds = mixStaggerId(deviceId) % windowSeconds;
+        }
     }
 
     // retrieve what the current time the AlarmManager thinks it is
@@ -168,7 +338,7 @@ public:
     RtcDateTime Now() const
     {
         uint32_t msNow = millis();
-        uint32_t secondsNow = _seconds + (msNow - _msLast) / 1000;
+        uint32_t secondsNow = _seconds + elapsedMs(msNow) / 1000;
         return RtcDateTime(secondsNow);
     }
 
@@ -179,101 +349,106 @@ public:
     int8_t AddAlarm(const RtcDateTime& when,
         uint32_t period)
     {
-        if (!when.IsValid())
-        {
-            return AlarmAddError_TimeInvalid;
-        }
-        if (period > AlarmPeriod_Monthly_31st &&
-            period < AlarmPeriod_StartOfSpecifics)
+        return addAlarm(when, period, nullptr);
+    }
+
+    // add an alarm in local time that keeps its wall clock time across
+    // daylight savings changes, so a daily alarm at 07:00 stays at 07:00,
+    // hourly and specific seconds periods keep their fixed length of time
+    // whenLocal - the local date and time to start triggering alarms
+    // period - the type of alarm, does it repeat and how often, see AlarmPeriod enum
+    // zone - the time zone rules, it must remain valid while the alarm is active
+    //     as only a reference to it is retained
+    // return - if positive, the id of the Alarm, otherwise see AlarmAddError
+    int8_t AddAlarm(const RtcDateTime& whenLocal,
+        uint32_t period,
+        const RtcTimeZoneRule& zone)
+    {
+        return addAlarm(whenLocal, period, &zone);
+    }
+
+    // add an alarm that triggers on a repeating schedule
+    // schedule - the schedule, it must remain valid while the alarm is active
+    //     as only a reference to it is retained
+    // return - if positive, the id of the Alarm, otherwise see AlarmAddError
+    int8_t AddAlarm(const RtcCronSchedule& schedule)
+    {
+        uint32_t seconds = schedule.NextAfter(Now().TotalSeconds());
+        if (seconds == 0)
         {
             return AlarmAddError_PeriodInvalid;
         }
 
-        int8_t result = AlarmAddError_TimeInvalid;
-        uint32_t seconds = when.TotalSeconds();
+        Alarm alarm(seconds, AlarmPeriod_Schedule);
+        alarm.Schedule = &schedule;
 
-        if (period == AlarmPeriod_Monthly_LastDay)
-        {
-            period = AlarmPeriod_Monthly_31st;
-            // adjust given when to last day of its set month
-            uint8_t daysInMonth = RtcDateTime::DaysInMonth(when.Year(), when.Month());
-            if (when.Day() < daysInMonth)
-            {
-                RtcDateTime temp(when.Year(),
-                    when.Month(),
-                    daysInMonth,
-                    when.Hour(),
-                    when.Minute(),
-                    when.Second());
-                seconds = temp.TotalSeconds();
-            }
-        }
-        else if (period == AlarmPeriod_Monthly ||
-            (period >= AlarmPeriod_Monthly_29th && period <= AlarmPeriod_Monthly_31st))
-        {
-            period = AlarmPeriod_Monthly;
-            // adjust alarm period to store target day of month
-            // for when months have less days than the target
-            // it will trigger on the last day of the month but
-            // retain and trigger on specific day of month when
-            // available
-            if (when.Day() == 29)
-            {
-                period = AlarmPeriod_Monthly_29th;
-            }
-            else if (when.Day() == 30)
-            {
-                period = AlarmPeriod_Monthly_30th;
-            }
-            else if (when.Day() == 31)
-            {
-                period = AlarmPeriod_Monthly_31st;
-            }
-        }
-        else if (period == AlarmPeriod_Yearly)
+        return addAlarm(alarm);
+    }
+
+    // add an alarm with millisecond resolution
+    // msPeriod - the milliseconds from now until the alarm triggers and, 
+    //     unless singleFire, the period it repeats at from then on
+    // singleFire - trigger only once rather than repeating
+    // return - if positive, the id of the Alarm, otherwise see AlarmAddError
+    // 
+    // NOTE: Calling ProcessAlarms() at least as often as the smallest 
+    // msPeriod used is required to get the expected accuracy
+    int8_t AddAlarmMs(uint32_t msPeriod, bool singleFire = false)
+    {
+        if (msPeriod == 0 || (msPeriod & c_AlarmPeriodMsFlag))
         {
-            if (when.Day() == 29 && when.Month() == 2)
-            {
-                // adjust alarm period to store target day of month
-                // for when Feb 29th is target but following year isn't 
-                // a leap year it will trigger on the last day of Feb but
-                // retain and trigger on specific day of month when
-                // available
-                period = AlarmPeriod_Yearly_Feb29th;
-            }
+            return AlarmAddError_PeriodInvalid;
         }
 
-        Alarm alarm(seconds, period);
+        // the position within the current second is retained in
+        // the alarm so it can trigger partway through a second
+        uint32_t msFromSecond = elapsedMs(millis()) + msPeriod;
+        Alarm alarm(_seconds + msFromSecond / 1000, 
+            singleFire ? c_AlarmPeriodMsFlag : (msPeriod | c_AlarmPeriodMsFlag),
+            msFromSecond % 1000);
 
-        // if the alarm was added that was already in the past,
-        // we increment the when to the next repeat
-        // for non-repeatable alarms this may expire them
-        if (seconds <= _seconds)
+        int8_t result = addAlarm(alarm);
+        if (result >= 0)
         {
-            alarm.IncrementWhen();
+            _msAlarmsCount++;
         }
+        return result;
+    }
 
-        if (alarm.Period == AlarmPeriod_Expired)
+#if RTC_ALARM_QUEUE_SIZE > 0
+    // safe to call from an ISR, queues a single fire alarm that will 
+    // be added by the next call to ProcessAlarms(), replacing any alarm 
+    // already using the id
+    // id - a reserved id, see Begin()
+    // msDelay - milliseconds from this call until the alarm triggers,
+    //     up to c_AlarmQueueMaxMs
+    // return - false if the queue is full, the id is not reserved or
+    //     the delay is too long
+    //
+    // NOTE: only one ISR (or the main loop, but not both) may queue 
+    // alarms, as the queue is single producer
+    bool ISR_ATTR QueueAlarmMs(uint8_t id, uint32_t msDelay)
+    {
+        if (id >= _alarmsReserved || msDelay > c_AlarmQueueMaxMs)
         {
-            result = AlarmAddError_TimePast;
+            return false;
         }
-        else
-        {
-            result = AlarmAddError_CountExceeded;
+        return queueAlarm(id, msDelay);
+    }
 
-            for (uint8_t id = 0; id < _alarmsCount; id++)
-            {
-                if (_alarms[id].Period == AlarmPeriod_Expired)
-                {
-                    _alarms[id] = alarm;
-                    result = id;
-                    break;
-                }
-            }
+    // safe to call from an ISR, queues the removal of an alarm that will 
+    // be applied by the next call to ProcessAlarms()
+    // id - a reserved id, see Begin()
+    // return - false if the queue is full or the id is not reserved
+    bool ISR_ATTR QueueRemoveAlarm(uint8_t id)
+    {
+        if (id >= _alarmsReserved)
+        {
+            return false;
         }
-        
-        return result;
+        return queueAlarm(id, c_AlarmQueueRemove);
     }
+#endif
 
     // remove an existing alarm 
     // id - previously returned id from AddAlarm()
@@ -281,6 +456,10 @@ public:
     {
         if (id < _alarmsCount)
         {
+            if (_alarms[id].IsMs())
+            {
+                _msAlarmsCount--;
+            }
             _alarms[id].Period = AlarmPeriod_Expired;
         }
     }
@@ -296,71 +475,397 @@ public:
         return false;
     }
 
+    // retrieve when the next active alarm will trigger, 
+    // useful for sleeping until it is needed, see RtcAlarmHandoff
+    // due - the time of the earliest active alarm
+    // id - optional, the id of that alarm
+    // return - false if there are no active alarms
+    bool NextAlarmDue(RtcDateTime* due, uint8_t* id = nullptr) const
+    {
+        const Alarm* next = nullptr;
+        uint8_t nextId = 0;
+
+        for (uint8_t alarm = 0; alarm < _alarmsCount; alarm++)
+        {
+            if (_alarms[alarm].Period != AlarmPeriod_Expired)
+            {
+                if (next == nullptr || _alarms[alarm].IsBefore(*next))
+                {
+                    next = &_alarms[alarm];
+                    nextId = alarm;
+                }
+            }
+        }
+
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        *due = RtcDateTime(next->When);
+        if (id != nullptr)
+        {
+            *id = nextId;
+        }
+        return true;
+    }
+
+    // the bytes of memory SaveAlarms() needs for the current alarms
+    uint16_t SaveAlarmsSize() const
+    {
+        return c_AlarmStoreHeaderSize + 
+            static_cast<uint16_t>(_alarmsCount) * c_AlarmStoreEntrySize;
+    }
+
+    // save the alarms into the memory of a RTC or EEPROM, like 
+    // RtcDS3232, RtcDS1307, RtcDS3234 or EepromAt24c32, so they can be
+    // restored after a reset by RestoreAlarms()
+    // only the entries that have changed since the last save are written
+    // alarms added with a RtcCronSchedule or RtcTimeZoneRule reference
+    // objects in memory, so they are saved as expired and must be added again
+    // only whole seconds are saved, so a millisecond alarm that is 
+    // restored triggers at the start of the second it was due in
+    // store - the RTC or EEPROM to save to
+    // memoryAddress - where in its memory to save, for EEPROM keep this a
+    //     multiple of 8 so entries will not cross pages
+    // return - true if successful
+    template <typename T_STORE> bool SaveAlarms(T_STORE& store, uint16_t memoryAddress)
+    {
+        uint8_t entry[c_AlarmStoreEntrySize];
+        uint16_t checksum = 0;
+        uint16_t entryAddress = memoryAddress + c_AlarmStoreHeaderSize;
+
+        for (uint8_t id = 0; id < _alarmsCount; id++)
+        {
+            const Alarm& alarm = _alarms[id];
+            uint32_t when = 0;
+            uint32_t period = AlarmPeriod_Expired;
+
+            if (alarm.Period != AlarmPeriod_Expired && 
+                alarm.Schedule == nullptr && 
+                alarm.Zone == nullptr)
+            {
+                when = alarm.When;
+                period = alarm.Period;
+            }
+            setStoreUint32(entry, when);
+            setStoreUint32(entry + 4, period);
+            updateStoreChecksum(&checksum, entry, c_AlarmStoreEntrySize);
+
+            if (!updateStore(store, entryAddress, entry, c_AlarmStoreEntrySize))
+            {
+                return false;
+            }
+            entryAddress += c_AlarmStoreEntrySize;
+        }
+
+        // the header is written last so an interrupted save will
+        // fail the checksum rather than restore a mix of alarms
+        uint8_t header[c_AlarmStoreHeaderSize] = { 
+            c_AlarmStoreMagic0, 
+            c_AlarmStoreMagic1, 
+            c_AlarmStoreVersion, 
+            _alarmsCount,
+            static_cast<uint8_t>(checksum), 
+            static_cast<uint8_t>(checksum >> 8), 
+            0, 
+            0 };
+
+        return updateStore(store, memoryAddress, header, c_AlarmStoreHeaderSize);
+    }
+
+    // restore the alarms saved by SaveAlarms() with a burst read,
+    // replacing all current alarms
+    // call Sync() after so that alarms missed while the power was out 
+    // will trigger on the next ProcessAlarms() or be counted as missed
+    // by ProcessAlarmsCoalesced()
+    // store - the RTC or EEPROM to restore from
+    // memoryAddress - where in its memory the alarms were saved
+    // return - true if successful, if false, there will be no active alarms
+    template <typename T_STORE> bool RestoreAlarms(T_STORE& store, uint16_t memoryAddress)
+    {
+        uint8_t entry[c_AlarmStoreEntrySize];
+        uint16_t checksum = 0;
+
+        clearAlarms();
+
+        if (store.GetMemory(memoryAddress, entry, c_AlarmStoreHeaderSize) != c_AlarmStoreHeaderSize ||
+            entry[0] != c_AlarmStoreMagic0 ||
+            entry[1] != c_AlarmStoreMagic1 ||
+            entry[2] != c_AlarmStoreVersion ||
+            entry[3] > _alarmsCount)
+        {
+            return false;
+        }
+
+        uint8_t count = entry[3];
+        uint16_t checksumSaved = entry[4] | (static_cast<uint16_t>(entry[5]) << 8);
+
+        memoryAddress += c_AlarmStoreHeaderSize;
+        for (uint8_t id = 0; id < count; id++)
+        {
+            if (store.GetMemory(memoryAddress, entry, c_AlarmStoreEntrySize) != c_AlarmStoreEntrySize)
+            {
+                clearAlarms();
+                return false;
+            }
+            memoryAddress += c_AlarmStoreEntrySize;
+            updateStoreChecksum(&checksum, entry, c_AlarmStoreEntrySize);
+
+            _alarms[id] = Alarm(getStoreUint32(entry), getStoreUint32(entry + 4));
+        }
+
+        if (checksum != checksumSaved)
+        {
+            clearAlarms();
+            return false;
+        }
+
+        for (uint8_t id = 0; id < count; id++)
+        {
+            if (_alarms[id].IsMs())
+            {
+                _msAlarmsCount++;
+            }
+        }
+        return true;
+    }
+
     // process all the alarms which can trigger callbacks
     // call at regular intervals, if you need seconds accuracy, call
     // every second.  
     // There is little need to call this faster than a few
-    // times per second but it doesn't hurt anything
+    // times per second but it doesn't hurt anything, unless
+    // millisecond alarms are used, see AddAlarmMs()
     void ProcessAlarms(RtcAlarmCallback callback, void* context)
     {
-        uint32_t msNow = millis();
-        uint32_t msDelta = (msNow - _msLast);
+        processAlarms<false>([&](uint8_t id, const RtcDateTime& alarm, uint32_t)
+            {
+                callback(context, id, alarm);
+            });
+    }
 
-        if (msDelta > 1000)
-        {
-            // update seconds based on passed time using millis()
-            _seconds += msDelta / 1000;
-            _msLast = msNow - (msDelta % 1000); // retain fractional second
-            
-            // used a local seconds in case a callback changes it
-            uint32_t seconds = _seconds; 
+    // process all the alarms like ProcessAlarms(), but a periodic alarm 
+    // that has fallen behind more than one period, like after a long stall
+    // of the sketch or a Sync() that jumped forward, will only trigger once
+    // and then skip ahead to its next future time
+    // The callback is given the count of the periods that were missed 
+    // and the alarm is the time of the first missed period, for alarms
+    // of a RtcCronSchedule the count is only 1 when any were missed
+    void ProcessAlarmsCoalesced(RtcAlarmCoalescedCallback callback, void* context)
+    {
+        processAlarms<true>([&](uint8_t id, const RtcDateTime& alarm, uint32_t missed)
+            {
+                callback(context, id, alarm, missed);
+            });
+    }
 
-            for (uint8_t id = 0; id < _alarmsCount; id++)
+    // process all the alarms like ProcessAlarms(), but the callback can be
+    // any callable like a lambda with captures or a functor object, 
+    // it is called directly without a std::function or function pointer
+    // callback - called as callback(uint8_t id, const RtcDateTime& alarm)
+    template <typename T_CALLBACK> void ProcessAlarms(T_CALLBACK callback)
+    {
+        processAlarms<false>([&](uint8_t id, const RtcDateTime& alarm, uint32_t)
             {
-                if (_alarms[id].Period != AlarmPeriod_Expired)
-                {
-                    if (_alarms[id].When <= seconds)
-                    {
-                        RtcDateTime alarm(_alarms[id].When);
+                callback(id, alarm);
+            });
+    }
 
-                        if (_alarms[id].Period == AlarmPeriod_SingleFire)
-                        {
-                            // remove from list
-                            _alarms[id].Period = AlarmPeriod_Expired;
-                        }
-                        else
-                        {
-                            _alarms[id].IncrementWhen();
-                        }
+    // process all the alarms like ProcessAlarmsCoalesced(), but the callback 
+    // can be any callable like ProcessAlarms(T_CALLBACK)
+    // callback - called as callback(uint8_t id, const RtcDateTime& alarm, uint32_t missed)
+    template <typename T_CALLBACK> void ProcessAlarmsCoalesced(T_CALLBACK callback)
+    {
+        processAlarms<true>(callback);
+    }
 
-                        // make callback
-                        callback(context, id, alarm);
-                    }
-                }
+#if defined(RTC_ALARM_STATISTICS)
+    const RtcAlarmStatistics& Statistics() const
+    {
+        return _statistics;
+    }
+
+    // the count of times the alarm has triggered since it was added
+    // id - previously returned id from AddAlarm()
+    uint32_t AlarmTriggerCount(uint8_t id) const
+    {
+        return (id < _alarmsCount) ? _alarms[id].TriggerCount : 0;
+    }
+
+    // the latest the alarm has triggered since it was added
+    // id - previously returned id from AddAlarm()
+    uint32_t AlarmLatenessMaxMs(uint8_t id) const
+    {
+        return (id < _alarmsCount) ? _alarms[id].LatenessMaxMs : 0;
+    }
+
+    void ResetStatistics()
+    {
+        _statistics.Reset();
+        for (uint8_t id = 0; id < _alarmsCount; id++)
+        {
+            _alarms[id].TriggerCount = 0;
+            _alarms[id].LatenessMaxMs = 0;
+        }
+    }
+
+    // print the statistics as text, one line of values per topic
+    void PrintStatistics(Stream& target) const
+    {
+        target.print("process count ");
+        target.print(_statistics.ProcessCount);
+        target.print(" intervalMaxMs ");
+        target.print(_statistics.IntervalMaxMs);
+        target.print(" durationMaxUs ");
+        target.print(_statistics.DurationMaxUs);
+        target.print(" durationAvgUs ");
+        target.print(_statistics.ProcessCount ? 
+            _statistics.DurationTotalUs / _statistics.ProcessCount : 0);
+        target.print(" secondsSkipped ");
+        target.println(_statistics.SecondsSkipped);
+
+        target.print("lateness");
+        for (uint8_t bucket = 0; bucket < c_AlarmLatenessBuckets; bucket++)
+        {
+            target.print(' ');
+            target.print(_statistics.LatenessCounts[bucket]);
+        }
+        target.println();
+
+        for (uint8_t id = 0; id < _alarmsCount; id++)
+        {
+            if (_alarms[id].TriggerCount)
+            {
+                target.print("alarm ");
+                target.print(id);
+                target.print(" triggers ");
+                target.print(_alarms[id].TriggerCount);
+                target.print(" latenessMaxMs ");
+                target.println(_alarms[id].LatenessMaxMs);
             }
         }
     }
+#endif
 
 protected:
     struct Alarm
     {
         uint32_t When; // seconds from RtcDateTime.TotalSeconds()
         uint32_t Period;  
+        uint16_t WhenMs; // milliseconds within the When second
+        const RtcCronSchedule* Schedule; // for AlarmPeriod_Schedule
+        const RtcTimeZoneRule* Zone; // for local time alarms, nullptr for UTC
+#if defined(RTC_ALARM_STATISTICS)
+        uint32_t TriggerCount;
+        uint32_t LatenessMaxMs;
+#endif
         
-        Alarm(uint32_t when = 0, uint32_t period = AlarmPeriod_Expired) :
+        Alarm(uint32_t when = 0, 
+                uint32_t period = AlarmPeriod_Expired, 
+                uint16_t whenMs = 0) :
             When(when),
-            Period(period)
+            Period(period),
+            WhenMs(whenMs),
+            Schedule(nullptr),
+            Zone(nullptr)
+#if defined(RTC_ALARM_STATISTICS)
+            ,
+            TriggerCount(0),
+            LatenessMaxMs(0)
+#endif
         {
         }
 
-        void IncrementWhen()
+        bool IsMs() const
         {
-            switch (Period)
+            return (Period & c_AlarmPeriodMsFlag);
+        }
+
+        // a millisecond alarm without a period is single fire
+        bool IsSingleFire() const
+        {
+            return (Period == AlarmPeriod_SingleFire || Period == c_AlarmPeriodMsFlag);
+        }
+
+        bool IsDue(uint32_t seconds, uint16_t ms) const
+        {
+            return (When < seconds || (When == seconds && WhenMs <= ms));
+        }
+
+        bool IsBefore(const Alarm& other) const
+        {
+            return (When < other.When || (When == other.When && WhenMs < other.WhenMs));
+        }
+
+        // periods that keep a wall clock time, so with a Zone they are 
+        // stepped in local time, all others are a fixed length of time
+        bool IsCalendar() const
+        {
+            switch (Period)
+            {
+            case AlarmPeriod_Yearly:
+            case AlarmPeriod_Yearly_Feb29th:
+            case AlarmPeriod_Monthly:
+            case AlarmPeriod_Monthly_29th:
+            case AlarmPeriod_Monthly_30th:
+            case AlarmPeriod_Monthly_31st:
+            case AlarmPeriod_Weekly:
+            case AlarmPeriod_Daily:
+            case AlarmPeriod_Schedule:
+                return true;
+
+            default:
+                return false;
+            }
+        }
+
+        void IncrementWhen()
+        {
+            if (Zone && IsCalendar())
+            {
+                // step in local time so the alarm keeps its wall clock
+                // time across daylight savings changes, a fixed length
+                // period steps in UTC so the repeated hour is not lost
+                When = Zone->ToLocal(When);
+                incrementPeriod();
+                When = Zone->ToUtc(When);
+            }
+            else
+            {
+                incrementPeriod();
+            }
+        }
+
+        // increment When to the first period after the given time
+        // which must be at or after When
+        // return - the count of periods skipped 
+        uint32_t IncrementWhenPast(uint32_t seconds, uint16_t ms)
+        {
+            uint32_t missed;
+
+            if (Zone && IsCalendar())
+            {
+                When = Zone->ToLocal(When);
+                missed = incrementPeriodPast(Zone->ToLocal(seconds), ms);
+                When = Zone->ToUtc(When);
+            }
+            else
+            {
+                missed = incrementPeriodPast(seconds, ms);
+            }
+            return missed;
+        }
+
+        void incrementPeriod()
+        {
+            switch (Period)
             {
             case AlarmPeriod_Expired:
                 break;
 
             case AlarmPeriod_SingleFire:
+            case c_AlarmPeriodMsFlag:
                 Period = AlarmPeriod_Expired;
                 break;
 
@@ -443,6 +948,14 @@ protected:
                 }
                 break;
 
+            case AlarmPeriod_Schedule:
+                When = Schedule->NextAfter(When);
+                if (When == 0)
+                {
+                    Period = AlarmPeriod_Expired;
+                }
+                break;
+
             case AlarmPeriod_Weekly:
                 When += c_WeekAsSeconds;
                 break;
@@ -456,15 +969,562 @@ protected:
                 break;
 
             default:
-                When += Period;
+                if (IsMs())
+                {
+                    uint32_t ms = WhenMs + (Period & ~c_AlarmPeriodMsFlag);
+                    When += ms / 1000;
+                    WhenMs = ms % 1000;
+                }
+                else
+                {
+                    When += Period;
+                }
                 break;
             }
         }
+
+        uint32_t incrementPeriodPast(uint32_t seconds, uint16_t ms)
+        {
+            uint64_t missed = 0;
+
+            if (IsMs())
+            {
+                // fixed period in milliseconds, can calculate directly
+                uint32_t msPeriod = (Period & ~c_AlarmPeriodMsFlag);
+                uint64_t msLate = static_cast<uint64_t>(seconds - When) * 1000 + ms - WhenMs;
+                missed = msLate / msPeriod;
+
+                uint64_t msNext = WhenMs + (missed + 1) * msPeriod;
+                When += msNext / 1000;
+                WhenMs = msNext % 1000;
+            }
+            else
+            {
+                uint32_t period = 0;
+
+                switch (Period)
+                {
+                case AlarmPeriod_Weekly:
+                    period = c_WeekAsSeconds;
+                    break;
+
+                case AlarmPeriod_Daily:
+                    period = c_DayAsSeconds;
+                    break;
+
+                case AlarmPeriod_Hourly:
+                    period = c_HourAsSeconds;
+                    break;
+
+                default:
+                    if (Period >= AlarmPeriod_StartOfSpecifics)
+                    {
+                        period = Period;
+                    }
+                    break;
+                }
+
+                if (period)
+                {
+                    // fixed period in seconds, can calculate directly
+                    missed = (seconds - When) / period;
+                    When += (missed + 1) * period;
+                }
+                else if (Period == AlarmPeriod_Schedule)
+                {
+                    // a schedule may match every minute, so rather than
+                    // stepping through every match it jumps straight past
+                    // seconds, only counting that at least one was missed
+                    incrementPeriod();
+                    if (Period != AlarmPeriod_Expired && When <= seconds)
+                    {
+                        missed = 1;
+                        When = Schedule->NextAfter(seconds);
+                        if (When == 0)
+                        {
+                            Period = AlarmPeriod_Expired;
+                        }
+                    }
+                }
+                else
+                {
+                    // calendar periods vary in length, 
+                    // so step through them
+                    incrementPeriod();
+                    while (Period != AlarmPeriod_Expired && When <= seconds)
+                    {
+                        incrementPeriod();
+                        missed++;
+                    }
+                }
+            }
+
+            return (missed > UINT32_MAX) ? UINT32_MAX : missed;
+        }
     };
 
     Alarm* _alarms; // table of possible alarms
     uint8_t _alarmsCount; // max alarms in _alarms
+    uint8_t _alarmsReserved; // ids not used by AddAlarm()
+    uint8_t _msAlarmsCount; // active alarms with a millisecond period
     uint32_t _msLast; // the last call to millis()
     uint32_t _seconds; // the approximate date time, as seconds from 2000
+
+    int32_t _driftPpm; // the estimated error of millis()
+    bool _driftLearned; // _driftPpm has been estimated or set
+    uint32_t _staggerSeconds; // added to repeating alarms, see SetStagger()
+    uint32_t _secondsSyncRef; // the trusted seconds that drift is measured from
+    bool _syncRefAtEdge; // _secondsSyncRef was synced at the start of the second
+    uint32_t _msSyncLast; // the millis() at the last Sync()
+    uint64_t _msSyncSpan; // the millis() that have passed since _secondsSyncRef
+    bool _checkPending; // Sync() moved the seconds forward, see processAlarms()
+
+#if defined(RTC_ALARM_STATISTICS)
+    uint32_t _msLastProcess; // the millis() of the last process alarms call
+    RtcAlarmStatistics _statistics;
+#endif
+
+    // the milliseconds since _msLast, corrected for drift
+    uint32_t elapsedMs(uint32_t msNow) const
+    {
+        uint32_t ms = msNow - _msLast;
+        if (_driftPpm)
+        {
+            ms -= static_cast<int64_t>(ms) * _driftPpm / 1000000;
+        }
+        return ms;
+    }
+
+    // convert drift corrected milliseconds back to millis() units
+    uint32_t rawMs(uint32_t ms) const
+    {
+        if (_driftPpm)
+        {
+            ms += static_cast<int64_t>(ms) * _driftPpm / 1000000;
+        }
+        return ms;
+    }
+
+    // the drift is measured across all the syncs since the reference 
+    // sync, so it becomes more accurate the longer it runs
+    void updateDrift(uint32_t msNow, uint32_t secondsNow, bool atSecondEdge)
+    {
+        bool restart = (_secondsSyncRef == 0 || secondsNow < _secondsSyncRef);
+
+        if (!restart)
+        {
+            _msSyncSpan += (msNow - _msSyncLast);
+
+            uint32_t span = secondsNow - _secondsSyncRef;
+            uint32_t spanMin = (_syncRefAtEdge && atSecondEdge) ? 
+                c_AlarmDriftMinSpanAtEdge : 
+                c_AlarmDriftMinSpan;
+
+            if (span >= spanMin)
+            {
+                int64_t msError = static_cast<int64_t>(_msSyncSpan) - static_cast<int64_t>(span) * 1000;
+                int64_t ppm = msError * 1000 / span;
+
+                if (ppm > c_AlarmDriftMaxPpm || ppm < -c_AlarmDriftMaxPpm)
+                {
+                    // the time was changed, not drifted
+                    restart = true;
+                }
+                else if (_driftLearned)
+                {
+                    // average with what was already learned so a 
+                    // single poor sync can't swing it
+                    _driftPpm = (_driftPpm + static_cast<int32_t>(ppm)) / 2;
+                }
+                else
+                {
+                    _driftPpm = ppm;
+                    _driftLearned = true;
+                }
+            }
+        }
+
+        if (restart)
+        {
+            _secondsSyncRef = secondsNow;
+            _syncRefAtEdge = atSecondEdge;
+            _msSyncSpan = 0;
+        }
+        _msSyncLast = msNow;
+    }
+
+    template <bool V_COALESCE, typename T_CALLBACK> void processAlarms(T_CALLBACK callback)
+    {
+        uint32_t msNow = millis();
+        uint32_t msDelta = elapsedMs(msNow);
+        bool secondsChanged = false;
+
+#if defined(RTC_ALARM_STATISTICS)
+        uint32_t usStart = micros();
+
+        if (_statistics.ProcessCount++ > 0 && 
+            msNow - _msLastProcess > _statistics.IntervalMaxMs)
+        {
+            _statistics.IntervalMaxMs = msNow - _msLastProcess;
+        }
+        _msLastProcess = msNow;
+#endif
+
+        if (msDelta >= 1000)
+        {
+#if defined(RTC_ALARM_STATISTICS)
+            _statistics.SecondsSkipped += msDelta / 1000 - 1;
+#endif
+            // update seconds based on passed time using millis()
+            _seconds += msDelta / 1000;
+            msDelta %= 1000;
+            _msLast = msNow - rawMs(msDelta); // retain fractional second
+            secondsChanged = true;
+        }
+
+#if RTC_ALARM_QUEUE_SIZE > 0
+        drainQueue();
+#endif
+
+        // alarms only need to be checked when a second has passed
+        // unless there are millisecond alarms
+        if (secondsChanged || _checkPending || _msAlarmsCount)
+        {
+            _checkPending = false;
+
+            // used a local seconds in case a callback changes it
+            uint32_t seconds = _seconds; 
+            uint16_t ms = msDelta;
+
+            for (uint8_t id = 0; id < _alarmsCount; id++)
+            {
+                if (_alarms[id].Period != AlarmPeriod_Expired)
+                {
+                    if (_alarms[id].IsDue(seconds, ms))
+                    {
+                        RtcDateTime alarm(_alarms[id].When);
+                        uint32_t missed = 0;
+
+#if defined(RTC_ALARM_STATISTICS)
+                        recordTrigger(&_alarms[id], seconds, ms);
+#endif
+
+                        if (_alarms[id].IsSingleFire())
+                        {
+                            // remove from list
+                            RemoveAlarm(id);
+                        }
+                        else if (V_COALESCE)
+                        {
+                            missed = _alarms[id].IncrementWhenPast(seconds, ms);
+                        }
+                        else
+                        {
+                            _alarms[id].IncrementWhen();
+                        }
+
+                        // make callback
+                        callback(id, alarm, missed);
+                    }
+                }
+            }
+        }
+
+#if defined(RTC_ALARM_STATISTICS)
+        uint32_t usDuration = micros() - usStart;
+
+        _statistics.DurationTotalUs += usDuration;
+        if (usDuration > _statistics.DurationMaxUs)
+        {
+            _statistics.DurationMaxUs = usDuration;
+        }
+#endif
+    }
+
+    // spreads similar ids across all the bits, the MurmurHash3 finalizer
+    static uint32_t mixStaggerId(uint32_t id)
+    {
+        id ^= id >> 16;
+        id *= 0x85ebca6b;
+        id ^= id >> 13;
+        id *= 0xc2b2ae35;
+        id ^= id >> 16;
+        return id;
+    }
+
+#if defined(RTC_ALARM_STATISTICS)
+    void recordTrigger(Alarm* alarm, uint32_t seconds, uint16_t ms)
+    {
+        uint32_t latenessMs = UINT32_MAX;
+        uint32_t latenessSeconds = seconds - alarm->When;
+
+        if (latenessSeconds < UINT32_MAX / 1000)
+        {
+            latenessMs = latenessSeconds * 1000 + ms - alarm->WhenMs;
+        }
+
+        alarm->TriggerCount++;
+        if (latenessMs > alarm->LatenessMaxMs)
+        {
+            alarm->LatenessMaxMs = latenessMs;
+        }
+        _statistics.LatenessCounts[RtcAlarmStatistics::LatenessBucket(latenessMs)]++;
+    }
+#endif
+
+    int8_t addAlarm(const RtcDateTime& when,
+        uint32_t period,
+        const RtcTimeZoneRule* zone)
+    {
+        if (!when.IsValid())
+        {
+            return AlarmAddError_TimeInvalid;
+        }
+        if ((period > AlarmPeriod_Monthly_31st &&
+            period < AlarmPeriod_StartOfSpecifics) ||
+            (period & c_AlarmPeriodMsFlag))
+        {
+            return AlarmAddError_PeriodInvalid;
+        }
+
+        uint32_t seconds = when.TotalSeconds();
+
+        if (period == AlarmPeriod_Monthly_LastDay)
+        {
+            period = AlarmPeriod_Monthly_31st;
+            // adjust given when to last day of its set month
+            uint8_t daysInMonth = RtcDateTime::DaysInMonth(when.Year(), when.Month());
+            if (when.Day() < daysInMonth)
+            {
+                RtcDateTime temp(when.Year(),
+                    when.Month(),
+                    daysInMonth,
+                    when.Hour(),
+                    when.Minute(),
+                    when.Second());
+                seconds = temp.TotalSeconds();
+            }
+        }
+        else if (period == AlarmPeriod_Monthly ||
+            (period >= AlarmPeriod_Monthly_29th && period <= AlarmPeriod_Monthly_31st))
+        {
+            period = AlarmPeriod_Monthly;
+            // adjust alarm period to store target day of month
+            // for when months have less days than the target
+            // it will trigger on the last day of the month but
+            // retain and trigger on specific day of month when
+            // available
+            if (when.Day() == 29)
+            {
+                period = AlarmPeriod_Monthly_29th;
+            }
+            else if (when.Day() == 30)
+            {
+                period = AlarmPeriod_Monthly_30th;
+            }
+            else if (when.Day() == 31)
+            {
+                period = AlarmPeriod_Monthly_31st;
+            }
+        }
+        else if (period == AlarmPeriod_Yearly)
+        {
+            if (when.Day() == 29 && when.Month() == 2)
+            {
+                // adjust alarm period to store target day of month
+                // for when Feb 29th is target but following year isn't 
+                // a leap year it will trigger on the last day of Feb but
+                // retain and trigger on specific day of month when
+                // available
+                period = AlarmPeriod_Yearly_Feb29th;
+            }
+        }
+
+        // the offset is only applied once, the period keeps it;
+        // calendar periods derive the next day of the month from When,
+        // so they are not offset as it could move them to another day
+        if (period == AlarmPeriod_Hourly ||
+            period == AlarmPeriod_Daily ||
+            period == AlarmPeriod_Weekly ||
+            period >= AlarmPeriod_StartOfSpecifics)
+        {
+            seconds += _staggerSeconds;
+        }
+
+        Alarm alarm(seconds, period);
+
+        if (zone)
+        {
+            alarm.Zone = zone;
+            alarm.When = zone->ToUtc(seconds);
+        }
+
+        // if the alarm was added that was already in the past,
+        // we increment the when to the next repeat
+        // for non-repeatable alarms this may expire them
+        if (alarm.When <= _seconds)
+        {
+            alarm.IncrementWhen();
+        }
+
+        if (alarm.Period == AlarmPeriod_Expired)
+        {
+            return AlarmAddError_TimePast;
+        }
+
+        return addAlarm(alarm);
+    }
+
+    static const uint8_t c_AlarmStoreMagic0 = 'R';
+    static const uint8_t c_AlarmStoreMagic1 = 'A';
+    static const uint8_t c_AlarmStoreVersion = 1;
+
+    void clearAlarms()
+    {
+        for (uint8_t id = 0; id < _alarmsCount; id++)
+        {
+            _alarms[id] = Alarm();
+        }
+        _msAlarmsCount = 0;
+    }
+
+    static void setStoreUint32(uint8_t* bytes, uint32_t value)
+    {
+        for (uint8_t index = 0; index < 4; index++)
+        {
+            bytes[index] = static_cast<uint8_t>(value >> (index * 8));
+        }
+    }
+
+    static uint32_t getStoreUint32(const uint8_t* bytes)
+    {
+        uint32_t value = 0;
+        for (uint8_t index = 0; index < 4; index++)
+        {
+            value |= static_cast<uint32_t>(bytes[index]) << (index * 8);
+        }
+        return value;
+    }
+
+    // Fletcher-16
+    static void updateStoreChecksum(uint16_t* checksum, const uint8_t* bytes, uint8_t count)
+    {
+        uint16_t sum1 = *checksum & 0xff;
+        uint16_t sum2 = *checksum >> 8;
+
+        while (count-- > 0)
+        {
+            sum1 = (sum1 + *bytes++) % 255;
+            sum2 = (sum2 + sum1) % 255;
+        }
+        *checksum = (sum2 << 8) | sum1;
+    }
+
+    // write the bytes only if they differ from what is in the store,
+    // saving bus time and EEPROM wear
+    // count - the header or entry size
+    template <typename T_STORE> static bool updateStore(T_STORE& store, 
+        uint16_t memoryAddress, 
+        const uint8_t* bytes,
+        uint8_t count)
+    {
+        static_assert(c_AlarmStoreHeaderSize <= c_AlarmStoreEntrySize,
+            "the header must fit the buffer for an entry");
+        uint8_t stored[c_AlarmStoreEntrySize];
+
+        if (store.GetMemory(memoryAddress, stored, count) == count &&
+            memcmp(stored, bytes, count) == 0)
+        {
+            return true;
+        }
+        return (store.SetMemory(memoryAddress, bytes, count) == count);
+    }
+
+    int8_t addAlarm(const Alarm& alarm)
+    {
+        for (uint8_t id = _alarmsReserved; id < _alarmsCount; id++)
+        {
+            if (_alarms[id].Period == AlarmPeriod_Expired)
+            {
+                _alarms[id] = alarm;
+                return id;
+            }
+        }
+        return AlarmAddError_CountExceeded;
+    }
+
+#if RTC_ALARM_QUEUE_SIZE > 0
+    struct QueuedAlarm
+    {
+        uint32_t MsQueued; // millis() when queued
+        uint32_t MsDelay; // or c_AlarmQueueRemove
+        uint8_t Id;
+    };
+
+    static const uint32_t c_AlarmQueueRemove = 0xffffffff;
+    static const uint8_t c_AlarmQueueSlots = RTC_ALARM_QUEUE_SIZE + 1; // one always empty
+
+    // single producer, single consumer ring, the head is only 
+    // changed by the producer and the tail by the consumer
+    volatile QueuedAlarm _queue[c_AlarmQueueSlots];
+    volatile uint8_t _queueHead;
+    volatile uint8_t _queueTail;
+
+    bool ISR_ATTR queueAlarm(uint8_t id, uint32_t msDelay)
+    {
+        uint8_t head = _queueHead;
+        uint8_t next = (head + 1) % c_AlarmQueueSlots;
+
+        if (next == _queueTail)
+        {
+            return false; // full
+        }
+
+        _queue[head].MsQueued = millis();
+        _queue[head].MsDelay = msDelay;
+        _queue[head].Id = id;
+        // publish only after the entry is complete
+        _queueHead = next;
+        return true;
+    }
+
+    void drainQueue()
+    {
+        while (_queueTail != _queueHead)
+        {
+            uint8_t tail = _queueTail;
+            uint32_t msQueued = _queue[tail].MsQueued;
+            uint32_t msDelay = _queue[tail].MsDelay;
+            uint8_t id = _queue[tail].Id;
+            // release the entry back to the producer
+            _queueTail = (tail + 1) % c_AlarmQueueSlots;
+
+            if (id >= _alarmsCount)
+            {
+                continue;
+            }
+
+            RemoveAlarm(id);
+
+            if (msDelay != c_AlarmQueueRemove)
+            {
+                // relative to the current second, it may have been queued
+                // before the current second started, with the delay limited
+                // to c_AlarmQueueMaxMs this only overflows if it waited 
+                // in the queue for weeks
+                int32_t msFromSecond = static_cast<int32_t>(msQueued - _msLast) + msDelay;
+                if (msFromSecond < 0)
+                {
+                    msFromSecond = 0;
+                }
+
+                _alarms[id] = Alarm(_seconds + msFromSecond / 1000,
+                    c_AlarmPeriodMsFlag,
+                    msFromSecond % 1000);
+                _msAlarmsCount++;
+            }
+        }
+    }
+#endif
 };
 
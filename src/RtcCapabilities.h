@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcTemperature.h"
+
+// All of the RTC classes share the same core methods, so generic code
+// can be written once as a template on the RTC class, like 
+// RtcSquareWaveClock::Sync(), and there is no virtual call overhead...
+//
+//    void Begin();
+//    uint8_t LastError(); // see Rtc_Wire_Error_* 
+//    bool IsDateTimeValid();
+//    bool GetIsRunning();
+//    void SetIsRunning(bool isRunning);
+//    RtcDateTime GetDateTime();
+//    void SetDateTime(const RtcDateTime& dt);
+//
+// RtcCapabilities describes what else a given RTC class supports, the
+// values are constants so tests against them are removed by the compiler
+//
+//    if (RtcCapabilities<T_RTC>::HasAgingOffset) ...
+//
+// Calling a method that the RTC class doesn't have needs to be
+// kept out of the compile though, so select an overload with RtcFeature,
+// see RtcFeatures::GetTemperature() as a sample
+//
+//    doIt(rtc, RtcFeature<RtcCapabilities<T_RTC>::HasTemperature>());
+//
+template<class T_RTC> struct RtcCapabilities
+{
+    static const bool HasAlarms = false; // alarms on the chip itself
+    static const bool HasTimer = false; // a countdown timer
+    static const bool HasTemperature = false; // GetTemperature()
+    static const bool HasAgingOffset = false; // Get/SetAgingOffset()
+    static const bool HasMemory = false; // Get/SetMemory()
+    static const uint16_t MemorySize = 0; // bytes of battery backed memory
+};
+
+template<bool V_SUPPORTED> struct RtcFeature
+{
+};
+
+typedef RtcFeature<true> RtcFeatureSupported;
+typedef RtcFeature<false> RtcFeatureUnsupported;
+
+// features that can be called on any RTC, doing nothing
+// when the RTC class doesn't support them
+class RtcFeatures
+{
+public:
+    // *temperature - [out] filled with the temperature of the RTC
+    // returns - false if the RTC doesn't have a temperature sensor
+    template<class T_RTC> static bool GetTemperature(T_RTC& rtc, RtcTemperature* temperature)
+    {
+        return getTemperature(rtc, 
+            temperature, 
+            RtcFeature<RtcCapabilities<T_RTC>::HasTemperature>());
+    }
+
+protected:
+    template<class T_RTC> static bool getTemperature(T_RTC& rtc, 
+        RtcTemperature* temperature, 
+        RtcFeatureSupported)
+    {
+        *temperature = rtc.GetTemperature();
+        return (rtc.LastError() == Rtc_Wire_Error_None);
+    }
+
+    template<class T_RTC> static bool getTemperature(T_RTC&,
+        RtcTemperature*,
+        RtcFeatureUnsupported)
+    {
+        return false;
+    }
+};
@@ -0,0 +1,321 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+#include "RtcCronSchedule.h"
+
+const uint8_t c_CronNoBit = 0xff;
+
+// returns the index of the first set bit at or above the given bit
+// or c_CronNoBit if there isn't one
+static uint8_t NextBit(uint64_t mask, uint8_t bit)
+{
+    if (bit >= 64)
+    {
+        return c_CronNoBit;
+    }
+
+    mask >>= bit;
+    if (mask == 0)
+    {
+        return c_CronNoBit;
+    }
+
+    // count trailing zeros, split to keep the scan 32 bit where possible
+    uint32_t low = static_cast<uint32_t>(mask);
+    if (low)
+    {
+        return bit + __builtin_ctzl(low);
+    }
+    return bit + 32 + __builtin_ctzl(static_cast<uint32_t>(mask >> 32));
+}
+
+static bool ParseNumber(const char** scan, uint8_t* value)
+{
+    const char* number = *scan;
+    uint16_t result = 0;
+
+    while (**scan >= '0' && **scan <= '9')
+    {
+        result = result * 10 + (**scan - '0');
+        if (result > 255)
+        {
+            return false;
+        }
+        (*scan)++;
+    }
+
+    *value = result;
+    return (*scan != number);
+}
+
+bool RtcCronSchedule::parseField(const char** scan,
+    uint8_t min,
+    uint8_t max,
+    uint64_t* mask,
+    bool* isAny)
+{
+    *mask = 0;
+    *isAny = false;
+
+    // skip leading white space
+    while (**scan == ' ' || **scan == '\t')
+    {
+        (*scan)++;
+    }
+
+    for (;;)
+    {
+        uint8_t first = min;
+        uint8_t last = max;
+        uint8_t step = 1;
+
+        if (**scan == '*')
+        {
+            (*scan)++;
+            *isAny = (**scan != '/');
+        }
+        else
+        {
+            if (!ParseNumber(scan, &first))
+            {
+                return false;
+            }
+
+            if (**scan == '-')
+            {
+                (*scan)++;
+                if (!ParseNumber(scan, &last))
+                {
+                    return false;
+                }
+            }
+            else if (**scan != '/')
+            {
+                // single value
+                last = first;
+            }
+        }
+
+        if (**scan == '/')
+        {
+            (*scan)++;
+            if (!ParseNumber(scan, &step) || step == 0)
+            {
+                return false;
+            }
+        }
+
+        if (first < min || last > max || first > last)
+        {
+            return false;
+        }
+
+        for (uint16_t value = first; value <= last; value += step)
+        {
+            *mask |= (1ULL << value);
+        }
+
+        if (**scan != ',')
+        {
+            break;
+        }
+        (*scan)++;
+    }
+
+    // field must end with white space or the end of the expression
+    return (**scan == ' ' || **scan == '\t' || **scan == '\0');
+}
+
+bool RtcCronSchedule::Parse(const char* expression)
+{
+    const char* scan = expression;
+    uint64_t minutes;
+    uint64_t hours;
+    uint64_t daysOfMonth;
+    uint64_t months;
+    uint64_t daysOfWeek;
+    bool isAnyDayOfMonth;
+    bool isAnyDayOfWeek;
+    bool isAny;
+
+    *this = RtcCronSchedule();
+
+    if (!parseField(&scan, 0, 59, &minutes, &isAny) ||
+        !parseField(&scan, 0, 23, &hours, &isAny) ||
+        !parseField(&scan, 1, 31, &daysOfMonth, &isAnyDayOfMonth) ||
+        !parseField(&scan, 1, 12, &months, &isAny) ||
+        !parseField(&scan, 0, 7, &daysOfWeek, &isAnyDayOfWeek))
+    {
+        return false;
+    }
+
+    // trailing white space only
+    while (*scan == ' ' || *scan == '\t')
+    {
+        scan++;
+    }
+    if (*scan != '\0')
+    {
+        return false;
+    }
+
+    // 7 is also Sunday
+    if (daysOfWeek & _BV(7))
+    {
+        daysOfWeek |= _BV(0);
+    }
+
+    _minutes = minutes;
+    _hours = hours;
+    _daysOfMonth = daysOfMonth;
+    _months = months;
+    _daysOfWeek = daysOfWeek & 0x7f;
+    _flags = (isAnyDayOfMonth ? CronFlag_AnyDayOfMonth : 0) |
+        (isAnyDayOfWeek ? CronFlag_AnyDayOfWeek : 0);
+
+    return true;
+}
+
+// the days (bits 1-31) of the given month that match the schedule
+uint32_t RtcCronSchedule::daysInMonthMask(uint16_t year, uint8_t month) const
+{
+    uint8_t daysInMonth = RtcDateTime::DaysInMonth(year, month);
+    uint32_t validDays = ((1UL << daysInMonth) - 1) << 1;
+
+    if (_flags & CronFlag_AnyDayOfWeek)
+    {
+        return _daysOfMonth & validDays;
+    }
+
+    // rotate the days of week so bit 0 is the first day of the month,
+    // then repeat it across the weeks of the month
+    uint8_t firstDayOfWeek = RtcDateTime(year, month, 1, 0, 0, 0).DayOfWeek();
+    uint32_t week = ((_daysOfWeek >> firstDayOfWeek) | 
+        (_daysOfWeek << (7 - firstDayOfWeek))) & 0x7f;
+    uint32_t daysOfWeek = (week | 
+        (week << 7) | 
+        (week << 14) | 
+        (week << 21) | 
+        (week << 28)) << 1;
+
+    if (_flags & CronFlag_AnyDayOfMonth)
+    {
+        return daysOfWeek & validDays;
+    }
+    return (_daysOfMonth | daysOfWeek) & validDays;
+}
+
+uint32_t RtcCronSchedule::NextAfter(uint32_t seconds) const
+{
+    if (!IsValid())
+    {
+        return 0;
+    }
+
+    // start at the next whole minute
+    RtcDateTime start(seconds - (seconds % 60) + 60);
+    uint16_t year = start.Year();
+    uint8_t month = start.Month();
+    uint8_t day = start.Day();
+    uint8_t hour = start.Hour();
+    uint8_t minute = start.Minute();
+    uint16_t yearLast = year + c_CronSearchYears;
+
+    // each step either finds the field at or after the current value,
+    // resetting the lower fields if it moved, or carries into the 
+    // higher field when there isn't one
+    while (year <= yearLast)
+    {
+        uint8_t next = NextBit(_months, month);
+        if (next == c_CronNoBit)
+        {
+            year++;
+            month = 1;
+            day = 1;
+            hour = 0;
+            minute = 0;
+            continue;
+        }
+        if (next != month)
+        {
+            month = next;
+            day = 1;
+            hour = 0;
+            minute = 0;
+        }
+
+        next = NextBit(daysInMonthMask(year, month), day);
+        if (next == c_CronNoBit)
+        {
+            month++;
+            day = 1;
+            hour = 0;
+            minute = 0;
+            if (month > 12)
+            {
+                year++;
+                month = 1;
+            }
+            continue;
+        }
+        if (next != day)
+        {
+            day = next;
+            hour = 0;
+            minute = 0;
+        }
+
+        next = NextBit(_hours, hour);
+        if (next == c_CronNoBit)
+        {
+            // days past the end of the month will carry into the next month
+            day++;
+            hour = 0;
+            minute = 0;
+            continue;
+        }
+        if (next != hour)
+        {
+            hour = next;
+            minute = 0;
+        }
+
+        next = NextBit(_minutes, minute);
+        if (next == c_CronNoBit)
+        {
+            hour++;
+            minute = 0;
+            continue;
+        }
+
+        return RtcDateTime(year, month, day, hour, next, 0).TotalSeconds();
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+
+// how many years ahead NextAfter() will search for a match, 
+// enough to always find Feb 29th if it is scheduled
+const uint16_t c_CronSearchYears = 8;
+
+// A repeating schedule using the cron expression format
+// 
+// "minute hour dayOfMonth month dayOfWeek"
+// 
+// minute - 0-59
+// hour - 0-23
+// dayOfMonth - 1-31
+// month - 1-12
+// dayOfWeek - 0-7, 0 and 7 are both Sunday
+// 
+// each field can be...
+// * - any value
+// n - a specific value
+// n-m - a range of values
+// a,b,c - a list of values or ranges
+// */s, n-m/s, n/s - every s steps within the range
+//
+// if both the dayOfMonth and dayOfWeek are specified, a day matching 
+// either will trigger, as with cron
+// 
+// Sample, every weekday at 06:15 and 18:15...
+//    RtcCronSchedule schedule;
+//    schedule.Parse("15 6,18 * * 1-5");
+//
+// The fields are compiled into bitmasks so the next match is found 
+// by scanning bits rather than stepping through time
+//
+class RtcCronSchedule
+{
+public:
+    RtcCronSchedule() :
+        _minutes(0),
+        _hours(0),
+        _daysOfMonth(0),
+        _months(0),
+        _daysOfWeek(0),
+        _flags(0)
+    {
+    }
+
+    // parse the cron expression into this schedule
+    // return - false if the expression is invalid, leaving the
+    //     schedule without any matches
+    bool Parse(const char* expression);
+
+    bool IsValid() const
+    {
+        return (_minutes && _hours && _daysOfMonth && _months && _daysOfWeek);
+    }
+
+    // find the first time matching the schedule after the given time
+    // seconds - as from RtcDateTime.TotalSeconds()
+    // return - the seconds of the match, or 0 if there is no match
+    uint32_t NextAfter(uint32_t seconds) const;
+
+    RtcDateTime NextAfter(const RtcDateTime& after) const
+    {
+        return RtcDateTime(NextAfter(after.TotalSeconds()));
+    }
+
+protected:
+    uint64_t _minutes; // bits 0-59
+    uint32_t _hours; // bits 0-23
+    uint32_t _daysOfMonth; // bits 1-31
+    uint16_t _months; // bits 1-12
+    uint8_t _daysOfWeek; // bits 0-6
+    uint8_t _flags; // see CronFlag_
+
+    enum CronFlag
+    {
+        CronFlag_AnyDayOfMonth = 0x01,
+        CronFlag_AnyDayOfWeek = 0x02
+    };
+
+    uint32_t daysInMonthMask(uint16_t year, uint8_t month) const;
+
+    static bool parseField(const char** scan, 
+        uint8_t min, 
+        uint8_t max, 
+        uint64_t* mask, 
+        bool* isAny);
+};
@@ -29,6 +29,7 @@ License along with Rtc.  If not, see
 #include <Arduino.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCapabilities.h"
 #include "ThreeWire.h"
 
 
@@ -94,6 +95,13 @@ public:
         _wire.begin();
     }
 
+    // the 3 wire bus doesn't report errors, this is always 
+    // Rtc_Wire_Error_None so generic code can check it
+    uint8_t LastError()
+    {
+        return Rtc_Wire_Error_None;
+    }
+
     bool GetIsWriteProtected()
     {
         uint8_t wp = getReg(DS1302_REG_WP);
@@ -210,6 +218,14 @@ public:
         return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
     }
 
+    // read just the seconds, a much shorter transfer than GetDateTime()
+    // for polling until the seconds change, see RtcSecondEdge
+    uint8_t GetSecond()
+    {
+        // without the clock halt flag
+        return BcdToUint8(getReg(DS1302_REG_TIMEDATE) & 0x7F);
+    }
+
     void SetMemory(uint8_t memoryAddress, uint8_t value)
     {
         // memory addresses interleaved read and write addresses
@@ -289,3 +305,13 @@ private:
     }
 };
 
+template<class T_WIRE_METHOD> struct RtcCapabilities<RtcDS1302<T_WIRE_METHOD>>
+{
+    static const bool HasAlarms = false;
+    static const bool HasTimer = false;
+    static const bool HasTemperature = false;
+    static const bool HasAgingOffset = false;
+    static const bool HasMemory = true;
+    static const uint16_t MemorySize = DS1302RamSize;
+};
+
@@ -29,6 +29,8 @@ License along with Rtc.  If not, see
 #include <Arduino.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCapabilities.h"
+#include "RtcWireAsyncRead.h"
 
 //I2C Slave Address  
 const uint8_t DS1307_ADDRESS = 0x68;
@@ -146,29 +148,52 @@ public:
         _lastError = _wire.endTransmission();
         if (_lastError != Rtc_Wire_Error_None)
         {
-            RtcDateTime(0);
+            return RtcDateTime(0);
         }
 
         size_t bytesRead = _wire.requestFrom(DS1307_ADDRESS, DS1307_REG_TIMEDATE_SIZE);
         if (DS1307_REG_TIMEDATE_SIZE != bytesRead)
         {
             _lastError = Rtc_Wire_Error_Unspecific;
-            RtcDateTime(0);
+            return RtcDateTime(0);
         }
 
-        uint8_t second = BcdToUint8(_wire.read() & 0x7F);
-        uint8_t minute = BcdToUint8(_wire.read());
-        uint8_t hour = BcdToBin24Hour(_wire.read());
+        uint8_t regs[DS1307_REG_TIMEDATE_SIZE];
+        for (size_t index = 0; index < DS1307_REG_TIMEDATE_SIZE; index++)
+        {
+            regs[index] = _wire.read();
+        }
 
-        _wire.read();  // throwing away day of week as we calculate it
+        return decodeDateTime(regs);
+    }
 
-        uint8_t dayOfMonth = BcdToUint8(_wire.read());
-        uint8_t month = BcdToUint8(_wire.read());
-        uint16_t year = BcdToUint8(_wire.read()) + 2000;
+    // read just the seconds, a much shorter transfer than GetDateTime()
+    // for polling until the seconds change, see RtcSecondEdge
+    uint8_t GetSecond()
+    {
+        // without the clock halt flag
+        return BcdToUint8(getReg(DS1307_REG_TIMEDATE) & 0x7F);
+    }
 
-        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    // start reading the date and time in steps, 
+    // call request.Poll() until it completes, see RtcWireAsyncRead
+    // return - false if the request is busy
+    template<uint8_t V_SIZE> bool StartGetDateTime(RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        return request.Start(DS1307_ADDRESS, DS1307_REG_TIMEDATE, DS1307_REG_TIMEDATE_SIZE);
     }
 
+    // the date and time from a completed StartGetDateTime() request
+    template<uint8_t V_SIZE> RtcDateTime GetDateTime(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        if (!isRequestComplete(request))
+        {
+            return RtcDateTime(0);
+        }
+        return decodeDateTime(request.Data());
+    }
+
+
     void SetMemory(uint8_t memoryAddress, uint8_t value)
     {
         uint8_t address = memoryAddress + DS1307_REG_RAMSTART;
@@ -191,51 +216,78 @@ public:
 
     uint8_t SetMemory(uint8_t memoryAddress, const uint8_t* pValue, uint8_t countBytes)
     {
-        uint8_t address = memoryAddress + DS1307_REG_RAMSTART;
+        uint16_t address = memoryAddress + DS1307_REG_RAMSTART;
         uint8_t countWritten = 0;
-        if (address <= DS1307_REG_RAMEND)
+
+        // the register address takes one byte of each transaction
+        while (countBytes > 0 && address <= DS1307_REG_RAMEND)
         {
+            size_t countChunk = 0;
+
             _wire.beginTransmission(DS1307_ADDRESS);
-            _wire.write(address);
+            _wire.write(static_cast<uint8_t>(address));
 
-            while (countBytes > 0 && address <= DS1307_REG_RAMEND)
+            while (countBytes > 0 && 
+                address <= DS1307_REG_RAMEND &&
+                countChunk < (RTC_WIRE_BUFFER_SIZE - 1))
             {
                 _wire.write(*pValue++);
                 address++;
                 countBytes--;
-                countWritten++;
+                countChunk++;
             }
 
             _lastError = _wire.endTransmission();
+            if (_lastError != Rtc_Wire_Error_None)
+            {
+                break;
+            }
+            countWritten += countChunk;
         }
         return countWritten;
     }
 
     size_t GetMemory(uint8_t memoryAddress, uint8_t* pValue, size_t countBytes)
     {
-        uint8_t address = memoryAddress + DS1307_REG_RAMSTART;
+        uint16_t address = memoryAddress + DS1307_REG_RAMSTART;
         size_t countRead = 0;
         if (address <= DS1307_REG_RAMEND)
         {
-            if (countBytes > DS1307_REG_RAMSIZE)
+            if (countBytes > static_cast<size_t>(DS1307_REG_RAMEND - address + 1))
             {
-                countBytes = DS1307_REG_RAMSIZE;
+                countBytes = DS1307_REG_RAMEND - address + 1;
             }
 
             _wire.beginTransmission(DS1307_ADDRESS);
-            _wire.write(address);
+            _wire.write(static_cast<uint8_t>(address));
             _lastError = _wire.endTransmission();
             if (_lastError != Rtc_Wire_Error_None)
             {
                 return 0;
             }
 
-            countRead = _wire.requestFrom(DS1307_ADDRESS, countBytes);
-            countBytes = countRead;
-
-            while (countBytes-- > 0)
+            // the register address auto increments, so each following
+            // request continues where the last left off
+            while (countBytes > 0)
             {
-                *pValue++ = _wire.read();
+                // countBytes was already limited to the memory size, which
+                // keeps the chunk within the uint8_t count of requestFrom
+                size_t countChunk = (countBytes < RTC_WIRE_BUFFER_SIZE) ? countBytes : RTC_WIRE_BUFFER_SIZE;
+                size_t countReceived = _wire.requestFrom(DS1307_ADDRESS, static_cast<uint8_t>(countChunk));
+
+                for (size_t index = 0; index < countReceived; index++)
+                {
+                    *pValue++ = _wire.read();
+                }
+
+                countRead += countReceived;
+                countBytes -= countReceived;
+
+                if (countReceived != countChunk)
+                {
+                    _lastError = Rtc_Wire_Error_Unspecific;
+                    break;
+                }
             }
         }
 
@@ -251,6 +303,33 @@ private:
     T_WIRE_METHOD& _wire;
     uint8_t _lastError;
 
+    static RtcDateTime decodeDateTime(const uint8_t* regs)
+    {
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+        uint8_t minute = BcdToUint8(regs[1]);
+        uint8_t hour = BcdToBin24Hour(regs[2]);
+        // regs[3] day of week is thrown away as we calculate it
+        uint8_t dayOfMonth = BcdToUint8(regs[4]);
+        uint8_t month = BcdToUint8(regs[5]);
+        uint16_t year = BcdToUint8(regs[6]) + 2000;
+
+        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    }
+
+    template<uint8_t V_SIZE> bool isRequestComplete(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        _lastError = request.LastError();
+        if (request.State() != RtcAsyncState_Complete)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                _lastError = Rtc_Wire_Error_Unspecific;
+            }
+            return false;
+        }
+        return true;
+    }
+
     uint8_t getReg(uint8_t regAddress)
     {
         _wire.beginTransmission(DS1307_ADDRESS);
@@ -282,3 +361,13 @@ private:
     }
 };
 
+template<class T_WIRE_METHOD> struct RtcCapabilities<RtcDS1307<T_WIRE_METHOD>>
+{
+    static const bool HasAlarms = false;
+    static const bool HasTimer = false;
+    static const bool HasTemperature = false;
+    static const bool HasAgingOffset = false;
+    static const bool HasMemory = true;
+    static const uint16_t MemorySize = DS1307_REG_RAMEND - DS1307_REG_RAMSTART + 1;
+};
+
@@ -29,7 +29,9 @@ License along with Rtc.  If not, see
 #include <Arduino.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCapabilities.h"
 #include "RtcTemperature.h"
+#include "RtcWireAsyncRead.h"
 
 
 //I2C Slave Address  
@@ -243,12 +245,180 @@ enum DS3231AlarmFlag
     DS3231AlarmFlag_AlarmBoth = 0x03,
 };
 
+enum DS3231ConversionState
+{
+    DS3231ConversionState_Idle,
+    // an automatic conversion is running, ours is started once it is done
+    DS3231ConversionState_WaitingForBusy,
+    DS3231ConversionState_Converting,
+    DS3231ConversionState_Complete,
+    DS3231ConversionState_Timeout,
+    DS3231ConversionState_Error, // see LastError()
+};
+
+const uint16_t DS3231_CONVERSION_POLL_INTERVAL_MS = 10;
+const uint16_t DS3231_CONVERSION_TIMEOUT_MS = 500; // a busy wait plus our own conversion
+
+const size_t DS3231_REG_SNAPSHOT_SIZE = 0x13; // timedate through temp
+
+// the decoding of the date and time and the alarm registers, shared by
+// RtcDS3231 and DS3231Snapshot so they always agree
+class DS3231Registers
+{
+public:
+    // regs - starting at DS3231_REG_TIMEDATE
+    static RtcDateTime DecodeDateTime(const uint8_t* regs)
+    {
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+        uint8_t minute = BcdToUint8(regs[1]);
+        uint8_t hour = BcdToBin24Hour(regs[2]);
+        // regs[3] day of week is thrown away as we calculate it
+        uint8_t dayOfMonth = BcdToUint8(regs[4]);
+        uint8_t monthRaw = regs[5];
+        uint16_t year = BcdToUint8(regs[6]) + 2000;
+
+        if (monthRaw & _BV(7)) // century wrap flag
+        {
+            year += 100;
+        }
+        uint8_t month = BcdToUint8(monthRaw & 0x7f);
+
+        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    }
+
+    // regs - starting at DS3231_REG_ALARMONE
+    static DS3231AlarmOne DecodeAlarmOne(const uint8_t* regs)
+    {
+        uint8_t flags = (regs[0] & 0x80) >> 7;
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+
+        flags |= (regs[1] & 0x80) >> 6;
+        uint8_t minute = BcdToUint8(regs[1] & 0x7F);
+
+        flags |= (regs[2] & 0x80) >> 5;
+        uint8_t hour = BcdToBin24Hour(regs[2] & 0x7f);
+
+        flags |= (regs[3] & 0xc0) >> 3;
+        uint8_t dayOf = BcdToUint8(regs[3] & 0x3f);
+
+        if (flags == DS3231AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
+        {
+            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+        }
+
+        return DS3231AlarmOne(dayOf, hour, minute, second, (DS3231AlarmOneControl)flags);
+    }
+
+    // regs - starting at DS3231_REG_ALARMTWO
+    static DS3231AlarmTwo DecodeAlarmTwo(const uint8_t* regs)
+    {
+        uint8_t flags = (regs[0] & 0x80) >> 7;
+        uint8_t minute = BcdToUint8(regs[0] & 0x7F);
+
+        flags |= (regs[1] & 0x80) >> 6;
+        uint8_t hour = BcdToBin24Hour(regs[1] & 0x7f);
+
+        flags |= (regs[2] & 0xc0) >> 4;
+        uint8_t dayOf = BcdToUint8(regs[2] & 0x3f);
+
+        if (flags == DS3231AlarmTwoControl_HoursMinutesDayOfWeekMatch)
+        {
+            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+        }
+
+        return DS3231AlarmTwo(dayOf, hour, minute, (DS3231AlarmTwoControl)flags);
+    }
+};
+
+// all the registers from the time through the temperature, as read at
+// once by RtcDS3231::GetSnapshot(), with the same decoding as the 
+// individual Get methods
+class DS3231Snapshot
+{
+public:
+    DS3231Snapshot()
+    {
+        memset(_regs, 0, sizeof(_regs));
+    }
+
+    RtcDateTime DateTime() const
+    {
+        return DS3231Registers::DecodeDateTime(_regs + DS3231_REG_TIMEDATE);
+    }
+
+    DS3231AlarmOne AlarmOne() const
+    {
+        return DS3231Registers::DecodeAlarmOne(_regs + DS3231_REG_ALARMONE);
+    }
+
+    DS3231AlarmTwo AlarmTwo() const
+    {
+        return DS3231Registers::DecodeAlarmTwo(_regs + DS3231_REG_ALARMTWO);
+    }
+
+    uint8_t Control() const
+    {
+        return _regs[DS3231_REG_CONTROL];
+    }
+
+    uint8_t Status() const
+    {
+        return _regs[DS3231_REG_STATUS];
+    }
+
+    bool IsDateTimeValid() const
+    {
+        return !(Status() & _BV(DS3231_OSF));
+    }
+
+    bool IsRunning() const
+    {
+        return !(Control() & _BV(DS3231_EOSC));
+    }
+
+    DS3231AlarmFlag AlarmsTriggeredFlags() const
+    {
+        return (DS3231AlarmFlag)(Status() & DS3231_AIFMASK);
+    }
+
+    int8_t AgingOffset() const
+    {
+        return _regs[DS3231_REG_AGING];
+    }
+
+    RtcTemperature Temperature() const
+    {
+        return RtcTemperature(_regs[DS3231_REG_TEMP], _regs[DS3231_REG_TEMP + 1]);
+    }
+
+    // the raw registers, indexed by register address
+    const uint8_t* Registers() const
+    {
+        return _regs;
+    }
+
+protected:
+    uint8_t _regs[DS3231_REG_SNAPSHOT_SIZE];
+
+    template<class T_WIRE_METHOD> friend class RtcDS3231;
+};
+
 template<class T_WIRE_METHOD> class RtcDS3231
 {
 public:
     RtcDS3231(T_WIRE_METHOD& wire) :
         _wire(wire),
-        _lastError(Rtc_Wire_Error_None)
+        _lastError(Rtc_Wire_Error_None),
+        _regCacheEnabled(false),
+        _controlCached(false),
+        _statusCached(false),
+        _controlCache(0),
+        _statusCache(0),
+        _convState(DS3231ConversionState_Idle),
+        _convPollIntervalMs(DS3231_CONVERSION_POLL_INTERVAL_MS),
+        _convTimeoutMs(DS3231_CONVERSION_TIMEOUT_MS),
+        _convStartMs(0),
+        _convPollLastMs(0)
     {
     }
 
@@ -267,6 +437,23 @@ public:
         return _lastError;
     }
 
+    // cache the control and status registers so that changing the 
+    // configuration only writes them rather than reading them first
+    // only use when nothing else changes the configuration of the RTC,
+    // otherwise call InvalidateRegisterCache() after it has
+    void EnableRegisterCache(bool enable)
+    {
+        _regCacheEnabled = enable;
+        InvalidateRegisterCache();
+    }
+
+    // the next configuration change will read the registers again
+    void InvalidateRegisterCache()
+    {
+        _controlCached = false;
+        _statusCached = false;
+    }
+
     bool IsDateTimeValid()
     {
         uint8_t status = getReg(DS3231_REG_STATUS);
@@ -281,7 +468,7 @@ public:
 
     void SetIsRunning(bool isRunning)
     {
-        uint8_t creg = getReg(DS3231_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3231_REG_CONTROL);
         if (isRunning)
         {
             creg &= ~_BV(DS3231_EOSC);
@@ -290,15 +477,15 @@ public:
         {
             creg |= _BV(DS3231_EOSC);
         }
-        setReg(DS3231_REG_CONTROL, creg);
+        setConfigReg(DS3231_REG_CONTROL, creg);
     }
 
     void SetDateTime(const RtcDateTime& dt)
     {
         // clear the invalid flag
-        uint8_t status = getReg(DS3231_REG_STATUS);
+        uint8_t status = getConfigReg(DS3231_REG_STATUS);
         status &= ~_BV(DS3231_OSF); // clear the flag
-        setReg(DS3231_REG_STATUS, status);
+        setConfigReg(DS3231_REG_STATUS, status);
 
         // set the date time
         _wire.beginTransmission(DS3231_ADDRESS);
@@ -347,26 +534,41 @@ public:
             return RtcDateTime(0);
         }
 
-        uint8_t second = BcdToUint8(_wire.read() & 0x7F);
-        uint8_t minute = BcdToUint8(_wire.read());
-        uint8_t hour = BcdToBin24Hour(_wire.read());
+        uint8_t regs[DS3231_REG_TIMEDATE_SIZE];
+        for (size_t index = 0; index < DS3231_REG_TIMEDATE_SIZE; index++)
+        {
+            regs[index] = _wire.read();
+        }
+
+        return DS3231Registers::DecodeDateTime(regs);
+    }
 
-        _wire.read();  // throwing away day of week as we calculate it
+    // read just the seconds, a much shorter transfer than GetDateTime()
+    // for polling until the seconds change, see RtcSecondEdge
+    uint8_t GetSecond()
+    {
+        return BcdToUint8(getReg(DS3231_REG_TIMEDATE) & 0x7F);
+    }
 
-        uint8_t dayOfMonth = BcdToUint8(_wire.read());
-        uint8_t monthRaw = _wire.read();
-        uint16_t year = BcdToUint8(_wire.read()) + 2000;
+    // start reading the date and time in steps, 
+    // call request.Poll() until it completes, see RtcWireAsyncRead
+    // return - false if the request is busy
+    template<uint8_t V_SIZE> bool StartGetDateTime(RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        return request.Start(DS3231_ADDRESS, DS3231_REG_TIMEDATE, DS3231_REG_TIMEDATE_SIZE);
+    }
 
-        if (monthRaw & _BV(7)) // century wrap flag
+    // the date and time from a completed StartGetDateTime() request
+    template<uint8_t V_SIZE> RtcDateTime GetDateTime(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        if (!isRequestComplete(request))
         {
-            year += 100;
+            return RtcDateTime(0);
         }
-        uint8_t month = BcdToUint8(monthRaw & 0x7f);
-
-
-        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+        return DS3231Registers::DecodeDateTime(request.Data());
     }
 
+
     RtcTemperature GetTemperature()
     {
         _wire.beginTransmission(DS3231_ADDRESS);
@@ -402,9 +604,28 @@ public:
         return RtcTemperature( r11h, _wire.read() );  // LS byte is r12h
     }
 
+    // start reading the temperature in steps, 
+    // call request.Poll() until it completes, see RtcWireAsyncRead
+    // return - false if the request is busy
+    template<uint8_t V_SIZE> bool StartGetTemperature(RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        return request.Start(DS3231_ADDRESS, DS3231_REG_TEMP, DS3231_REG_TEMP_SIZE);
+    }
+
+    // the temperature from a completed StartGetTemperature() request
+    template<uint8_t V_SIZE> RtcTemperature GetTemperature(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        if (!isRequestComplete(request))
+        {
+            return RtcTemperature(0);
+        }
+        // MS byte is signed r11h, LS byte is r12h
+        return RtcTemperature(static_cast<int8_t>(request.Data()[0]), request.Data()[1]);
+    }
+
     void Enable32kHzPin(bool enable)
     {
-        uint8_t sreg = getReg(DS3231_REG_STATUS);
+        uint8_t sreg = getConfigReg(DS3231_REG_STATUS);
 
         if (enable == true)
         {
@@ -415,92 +636,108 @@ public:
             sreg &= ~_BV(DS3231_EN32KHZ);
         }
 
-        setReg(DS3231_REG_STATUS, sreg);
+        setConfigReg(DS3231_REG_STATUS, sreg);
     }
 
     void SetSquareWavePin(DS3231SquareWavePinMode pinMode, bool enableWhileInBatteryBackup = true)
     {
-        uint8_t creg = getReg(DS3231_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3231_REG_CONTROL);
 
-        // clear all relevant bits to a known "off" state
-        creg &= ~(DS3231_AIEMASK | _BV(DS3231_BBSQW));
-        creg |= _BV(DS3231_INTCN);  // set INTCN to disables clock SQW
-
-        if (pinMode != DS3231SquareWavePin_ModeNone)
-        {
-            if (pinMode == DS3231SquareWavePin_ModeClock)
-            {
-                creg &= ~_BV(DS3231_INTCN); // clear INTCN to enable clock SQW 
-            }
-            else
-            {
-                if (pinMode & DS3231SquareWavePin_ModeAlarmOne)
-                {
-                    creg |= _BV(DS3231_A1IE);
-                }
-                if (pinMode & DS3231SquareWavePin_ModeAlarmTwo)
-                {
-                    creg |= _BV(DS3231_A2IE);
-                }
-            }
-
-            if (enableWhileInBatteryBackup)
-            {
-                creg |= _BV(DS3231_BBSQW); // set enable int/sqw while in battery backup flag
-            }
-        }
-        setReg(DS3231_REG_CONTROL, creg);
+        creg = squareWavePinControl(creg, pinMode, enableWhileInBatteryBackup);
+        setConfigReg(DS3231_REG_CONTROL, creg);
     }
 
     void SetSquareWavePinClockFrequency(DS3231SquareWaveClock freq)
     {
-        uint8_t creg = getReg(DS3231_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3231_REG_CONTROL);
 
         creg &= ~DS3231_RSMASK; // Set to 0
         creg |= (freq & DS3231_RSMASK); // Set freq bits
 
-        setReg(DS3231_REG_CONTROL, creg);
+        setConfigReg(DS3231_REG_CONTROL, creg);
     }
 
 
     void SetAlarmOne(const DS3231AlarmOne& alarm)
     {
-        _wire.beginTransmission(DS3231_ADDRESS);
-        _wire.write(DS3231_REG_ALARMONE);
+        uint8_t regs[DS3231_REG_ALARMONE_SIZE];
 
-        _wire.write(Uint8ToBcd(alarm.Second()) | ((alarm.ControlFlags() & 0x01) << 7));
-        _wire.write(Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x02) << 6));
-        _wire.write(Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x04) << 5)); // 24 hour mode only
+        encodeAlarmOne(alarm, regs);
 
-        uint8_t rtcDow = alarm.DayOf();
-        if (alarm.ControlFlags() == DS3231AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
+        _wire.beginTransmission(DS3231_ADDRESS);
+        _wire.write(DS3231_REG_ALARMONE);
+        for (size_t index = 0; index < sizeof(regs); index++)
         {
-            rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
+            _wire.write(regs[index]);
         }
-
-        _wire.write(Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x18) << 3));
-
         _lastError = _wire.endTransmission();
     }
 
     void SetAlarmTwo(const DS3231AlarmTwo& alarm)
     {
+        uint8_t regs[DS3231_REG_ALARMTWO_SIZE];
+
+        encodeAlarmTwo(alarm, regs);
+
         _wire.beginTransmission(DS3231_ADDRESS);
         _wire.write(DS3231_REG_ALARMTWO);
+        for (size_t index = 0; index < sizeof(regs); index++)
+        {
+            _wire.write(regs[index]);
+        }
+        _lastError = _wire.endTransmission();
+    }
 
-        _wire.write(Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x01) << 7));
-        _wire.write(Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x02) << 6)); // 24 hour mode only
+    // set both alarms, the square wave pin mode, and clear the alarm 
+    // triggered flags all in one write, so a half configured alarm
+    // can't trigger and any flag set while writing is cleared
+    // the control and status registers are read first, unless cached
+    void SetAlarms(const DS3231AlarmOne& alarmOne,
+        const DS3231AlarmTwo& alarmTwo,
+        DS3231SquareWavePinMode pinMode,
+        bool enableWhileInBatteryBackup = true)
+    {
+        uint8_t creg;
+        uint8_t sreg;
 
-        // convert our Day of Week to Rtc Day of Week if needed
-        uint8_t rtcDow = alarm.DayOf();
-        if (alarm.ControlFlags() == DS3231AlarmTwoControl_HoursMinutesDayOfWeekMatch)
+        getConfigRegs(&creg, &sreg);
+        if (_lastError != Rtc_Wire_Error_None)
         {
-            rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
+            return;
         }
-        
-        _wire.write(Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x0c) << 4));
 
+        creg = squareWavePinControl(creg, pinMode, enableWhileInBatteryBackup);
+        creg &= ~_BV(DS3231_CONV); // don't start another conversion
+        sreg &= ~DS3231_AIFMASK; // clear the flags
+
+        // alarm one, alarm two, control, then status
+        uint8_t regs[DS3231_REG_ALARMONE_SIZE + DS3231_REG_ALARMTWO_SIZE + 2];
+
+        encodeAlarmOne(alarmOne, regs);
+        encodeAlarmTwo(alarmTwo, regs + DS3231_REG_ALARMONE_SIZE);
+        regs[DS3231_REG_CONTROL - DS3231_REG_ALARMONE] = creg;
+        regs[DS3231_REG_STATUS - DS3231_REG_ALARMONE] = sreg;
+
+        _wire.beginTransmission(DS3231_ADDRESS);
+        _wire.write(DS3231_REG_ALARMONE);
+        for (size_t index = 0; index < sizeof(regs); index++)
+        {
+            _wire.write(regs[index]);
+        }
         _lastError = _wire.endTransmission();
+
+        if (_regCacheEnabled)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                cacheReg(DS3231_REG_CONTROL, creg);
+                cacheReg(DS3231_REG_STATUS, sreg);
+            }
+            else
+            {
+                InvalidateRegisterCache();
+            }
+        }
     }
 
     DS3231AlarmOne GetAlarmOne()
@@ -520,28 +757,13 @@ public:
             return DS3231AlarmOne(0, 0, 0, 0, DS3231AlarmOneControl_HoursMinutesSecondsDayOfMonthMatch);
         }
 
-        uint8_t raw = _wire.read();
-        uint8_t flags = (raw & 0x80) >> 7;
-        uint8_t second = BcdToUint8(raw & 0x7F);
-
-        raw = _wire.read();
-        flags |= (raw & 0x80) >> 6;
-        uint8_t minute = BcdToUint8(raw & 0x7F);
-
-        raw = _wire.read();
-        flags |= (raw & 0x80) >> 5;
-        uint8_t hour = BcdToBin24Hour(raw & 0x7f);
-
-        raw = _wire.read();
-        flags |= (raw & 0xc0) >> 3;
-        uint8_t dayOf = BcdToUint8(raw & 0x3f);
-
-        if (flags == DS3231AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
+        uint8_t regs[DS3231_REG_ALARMONE_SIZE];
+        for (size_t index = 0; index < DS3231_REG_ALARMONE_SIZE; index++)
         {
-            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+            regs[index] = _wire.read();
         }
 
-        return DS3231AlarmOne(dayOf, hour, minute, second, (DS3231AlarmOneControl)flags);
+        return DS3231Registers::DecodeAlarmOne(regs);
     }
 
     DS3231AlarmTwo GetAlarmTwo()
@@ -561,24 +783,13 @@ public:
             return DS3231AlarmTwo(0, 0, 0, DS3231AlarmTwoControl_HoursMinutesDayOfMonthMatch);
         }
 
-        uint8_t raw = _wire.read();
-        uint8_t flags = (raw & 0x80) >> 7;
-        uint8_t minute = BcdToUint8(raw & 0x7F);
-
-        raw = _wire.read();
-        flags |= (raw & 0x80) >> 6;
-        uint8_t hour = BcdToBin24Hour(raw & 0x7f);
-
-        raw = _wire.read();
-        flags |= (raw & 0xc0) >> 4;
-        uint8_t dayOf = BcdToUint8(raw & 0x3f);
-
-        if (flags == DS3231AlarmTwoControl_HoursMinutesDayOfWeekMatch)
+        uint8_t regs[DS3231_REG_ALARMTWO_SIZE];
+        for (size_t index = 0; index < DS3231_REG_ALARMTWO_SIZE; index++)
         {
-            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+            regs[index] = _wire.read();
         }
 
-        return DS3231AlarmTwo(dayOf, hour, minute, (DS3231AlarmTwoControl)flags);
+        return DS3231Registers::DecodeAlarmTwo(regs);
     }
 
     // Latch must be called after an alarm otherwise it will not
@@ -588,7 +799,7 @@ public:
         uint8_t sreg = getReg(DS3231_REG_STATUS);
         uint8_t alarmFlags = (sreg & DS3231_AIFMASK);
         sreg &= ~DS3231_AIFMASK; // clear the flags
-        setReg(DS3231_REG_STATUS, sreg);
+        setConfigReg(DS3231_REG_STATUS, sreg);
         return (DS3231AlarmFlag)alarmFlags;
     }
   
@@ -597,7 +808,7 @@ public:
         uint8_t sreg = getReg(DS3231_REG_STATUS);
         uint8_t alarmFlags = (sreg & _BV(DS3231_A1F));
         sreg &= ~_BV(DS3231_A1F); // clear alarm flag 1
-        setReg(DS3231_REG_STATUS, sreg);
+        setConfigReg(DS3231_REG_STATUS, sreg);
         return (DS3231AlarmFlag)alarmFlags;
     }
 
@@ -606,7 +817,7 @@ public:
         uint8_t sreg = getReg(DS3231_REG_STATUS);
         uint8_t alarmFlags = (sreg & _BV(DS3231_A2F));
         sreg &= ~_BV(DS3231_A2F); // clear alarm flag 2
-        setReg(DS3231_REG_STATUS, sreg);
+        setConfigReg(DS3231_REG_STATUS, sreg);
         return (DS3231AlarmFlag)alarmFlags;
     }
 
@@ -622,17 +833,112 @@ public:
         return (sreg & _BV(DS3231_A2F));
     }
   
+    // when block is true, waits for the conversion to complete using 
+    // the polling interval and timeout of SetTemperatureCompensationPolling()
     void ForceTemperatureCompensationUpdate(bool block)
     {
-        uint8_t creg = getReg(DS3231_REG_CONTROL);
-        creg |= _BV(DS3231_CONV); // Write CONV bit
-        setReg(DS3231_REG_CONTROL, creg);
+        if (!block)
+        {
+            startConversion();
+            return;
+        }
+
+        DS3231ConversionState state = StartTemperatureCompensationUpdate();
+        while (isConverting(state))
+        {
+            yield();
+            state = PollTemperatureCompensationUpdate();
+        }
+    }
+
+    // set how often PollTemperatureCompensationUpdate() will read the device
+    // and how long in total it will wait before reporting a timeout
+    void SetTemperatureCompensationPolling(uint16_t intervalMs, uint16_t timeoutMs)
+    {
+        _convPollIntervalMs = intervalMs;
+        _convTimeoutMs = timeoutMs;
+    }
+
+    // start a temperature conversion without waiting for it, 
+    // if the device is busy with an automatic conversion then ours 
+    // will be started by PollTemperatureCompensationUpdate() once it is done
+    DS3231ConversionState StartTemperatureCompensationUpdate()
+    {
+        if (isConverting(_convState))
+        {
+            return _convState;
+        }
+
+        _convStartMs = millis();
+        _convPollLastMs = _convStartMs;
+
+        uint8_t sreg = getReg(DS3231_REG_STATUS);
+        if (_lastError != Rtc_Wire_Error_None)
+        {
+            _convState = DS3231ConversionState_Error;
+            return _convState;
+        }
+        if (sreg & _BV(DS3231_BSY))
+        {
+            _convState = DS3231ConversionState_WaitingForBusy;
+        }
+        else
+        {
+            _convState = startConversion();
+        }
+        return _convState;
+    }
+
+    // call often after StartTemperatureCompensationUpdate(), the device is
+    // only read once per polling interval, the returned state will
+    // be Complete, Timeout or Error when it is no longer converting
+    DS3231ConversionState PollTemperatureCompensationUpdate()
+    {
+        if (!isConverting(_convState))
+        {
+            return _convState;
+        }
+
+        uint32_t msNow = millis();
+        if ((msNow - _convPollLastMs) < _convPollIntervalMs)
+        {
+            return _convState;
+        }
+        _convPollLastMs = msNow;
+
+        if (_convState == DS3231ConversionState_WaitingForBusy)
+        {
+            uint8_t sreg = getReg(DS3231_REG_STATUS);
+            if (_lastError != Rtc_Wire_Error_None)
+            {
+                _convState = DS3231ConversionState_Error;
+                return _convState;
+            }
+            if ((sreg & _BV(DS3231_BSY)) == 0)
+            {
+                _convState = startConversion();
+            }
+        }
+        else
+        {
+            // the cache never holds CONV, so always read it
+            uint8_t creg = getReg(DS3231_REG_CONTROL);
+            if (_lastError != Rtc_Wire_Error_None)
+            {
+                _convState = DS3231ConversionState_Error;
+                return _convState;
+            }
+            if ((creg & _BV(DS3231_CONV)) == 0)
+            {
+                _convState = DS3231ConversionState_Complete;
+            }
+        }
 
-        while (block && (creg & _BV(DS3231_CONV)) != 0)
+        if (isConverting(_convState) && (msNow - _convStartMs) >= _convTimeoutMs)
         {
-            // Block until CONV is 0
-            creg = getReg(DS3231_REG_CONTROL);
+            _convState = DS3231ConversionState_Timeout;
         }
+        return _convState;
     }
 
     int8_t GetAgingOffset()
@@ -645,10 +951,250 @@ public:
         setReg(DS3231_REG_AGING, value);
     }
 
+    // read all the registers from the time through the temperature
+    // in one transaction, check LastError() for success
+    DS3231Snapshot GetSnapshot()
+    {
+        DS3231Snapshot snapshot;
+
+        _wire.beginTransmission(DS3231_ADDRESS);
+        _wire.write(DS3231_REG_TIMEDATE);
+        _lastError = _wire.endTransmission();
+        if (_lastError != Rtc_Wire_Error_None)
+        {
+            return snapshot;
+        }
+
+        size_t bytesRead = _wire.requestFrom(DS3231_ADDRESS, DS3231_REG_SNAPSHOT_SIZE);
+        if (DS3231_REG_SNAPSHOT_SIZE != bytesRead)
+        {
+            _lastError = Rtc_Wire_Error_Unspecific;
+            return snapshot;
+        }
+
+        for (size_t index = 0; index < DS3231_REG_SNAPSHOT_SIZE; index++)
+        {
+            snapshot._regs[index] = _wire.read();
+        }
+        return snapshot;
+    }
+
 protected:
     T_WIRE_METHOD& _wire;
     uint8_t _lastError;
 
+    static void encodeAlarmOne(const DS3231AlarmOne& alarm, uint8_t* regs)
+    {
+        regs[0] = Uint8ToBcd(alarm.Second()) | ((alarm.ControlFlags() & 0x01) << 7);
+        regs[1] = Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x02) << 6);
+        regs[2] = Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x04) << 5); // 24 hour mode only
+
+        uint8_t rtcDow = alarm.DayOf();
+        if (alarm.ControlFlags() == DS3231AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
+        {
+            rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
+        }
+
+        regs[3] = Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x18) << 3);
+    }
+
+    static void encodeAlarmTwo(const DS3231AlarmTwo& alarm, uint8_t* regs)
+    {
+        regs[0] = Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x01) << 7);
+        regs[1] = Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x02) << 6); // 24 hour mode only
+
+        // convert our Day of Week to Rtc Day of Week if needed
+        uint8_t rtcDow = alarm.DayOf();
+        if (alarm.ControlFlags() == DS3231AlarmTwoControl_HoursMinutesDayOfWeekMatch)
+        {
+            rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
+        }
+        
+        regs[2] = Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x0c) << 4);
+    }
+
+    static uint8_t squareWavePinControl(uint8_t creg, 
+        DS3231SquareWavePinMode pinMode, 
+        bool enableWhileInBatteryBackup)
+    {
+        // clear all relevant bits to a known "off" state
+        creg &= ~(DS3231_AIEMASK | _BV(DS3231_BBSQW));
+        creg |= _BV(DS3231_INTCN);  // set INTCN to disables clock SQW
+
+        if (pinMode != DS3231SquareWavePin_ModeNone)
+        {
+            if (pinMode == DS3231SquareWavePin_ModeClock)
+            {
+                creg &= ~_BV(DS3231_INTCN); // clear INTCN to enable clock SQW 
+            }
+            else
+            {
+                if (pinMode & DS3231SquareWavePin_ModeAlarmOne)
+                {
+                    creg |= _BV(DS3231_A1IE);
+                }
+                if (pinMode & DS3231SquareWavePin_ModeAlarmTwo)
+                {
+                    creg |= _BV(DS3231_A2IE);
+                }
+            }
+
+            if (enableWhileInBatteryBackup)
+            {
+                creg |= _BV(DS3231_BBSQW); // set enable int/sqw while in battery backup flag
+            }
+        }
+        return creg;
+    }
+
+    template<uint8_t V_SIZE> bool isRequestComplete(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        _lastError = request.LastError();
+        if (request.State() != RtcAsyncState_Complete)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                _lastError = Rtc_Wire_Error_Unspecific;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    bool _regCacheEnabled;
+    bool _controlCached;
+    bool _statusCached;
+    uint8_t _controlCache;
+    uint8_t _statusCache;
+
+    DS3231ConversionState _convState;
+    uint16_t _convPollIntervalMs;
+    uint16_t _convTimeoutMs;
+    uint32_t _convStartMs;
+    uint32_t _convPollLastMs;
+
+    static bool isConverting(DS3231ConversionState state)
+    {
+        return (state == DS3231ConversionState_WaitingForBusy ||
+            state == DS3231ConversionState_Converting);
+    }
+
+    DS3231ConversionState startConversion()
+    {
+        uint8_t creg = getConfigReg(DS3231_REG_CONTROL);
+        if (_lastError != Rtc_Wire_Error_None)
+        {
+            _convState = DS3231ConversionState_Error;
+            return _convState;
+        }
+        creg |= _BV(DS3231_CONV); // Write CONV bit
+        setConfigReg(DS3231_REG_CONTROL, creg);
+        if (_lastError != Rtc_Wire_Error_None)
+        {
+            _convState = DS3231ConversionState_Error;
+            return _convState;
+        }
+        return DS3231ConversionState_Converting;
+    }
+
+    // read a register to change its configuration bits, 
+    // using the cache when enabled
+    uint8_t getConfigReg(uint8_t regAddress)
+    {
+        if (_regCacheEnabled)
+        {
+            if (regAddress == DS3231_REG_CONTROL && _controlCached)
+            {
+                return _controlCache;
+            }
+            if (regAddress == DS3231_REG_STATUS && _statusCached)
+            {
+                return _statusCache;
+            }
+        }
+
+        uint8_t regValue = getReg(regAddress);
+        if (_regCacheEnabled && _lastError == Rtc_Wire_Error_None)
+        {
+            regValue = cacheReg(regAddress, regValue);
+        }
+        return regValue;
+    }
+
+    // read both the control and status registers in one transaction,
+    // or from the cache when enabled
+    void getConfigRegs(uint8_t* creg, uint8_t* sreg)
+    {
+        if (_regCacheEnabled && _controlCached && _statusCached)
+        {
+            _lastError = Rtc_Wire_Error_None;
+            *creg = _controlCache;
+            *sreg = _statusCache;
+            return;
+        }
+
+        _wire.beginTransmission(DS3231_ADDRESS);
+        _wire.write(DS3231_REG_CONTROL);
+        _lastError = _wire.endTransmission();
+        if (_lastError != Rtc_Wire_Error_None)
+        {
+            return;
+        }
+
+        size_t bytesRead = _wire.requestFrom(DS3231_ADDRESS, (uint8_t)2);
+        if (2 != bytesRead)
+        {
+            _lastError = Rtc_Wire_Error_Unspecific;
+            return;
+        }
+
+        *creg = _wire.read();
+        *sreg = _wire.read();
+        if (_regCacheEnabled)
+        {
+            *creg = cacheReg(DS3231_REG_CONTROL, *creg);
+            *sreg = cacheReg(DS3231_REG_STATUS, *sreg);
+        }
+    }
+
+    void setConfigReg(uint8_t regAddress, uint8_t regValue)
+    {
+        setReg(regAddress, regValue);
+        if (_regCacheEnabled)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                cacheReg(regAddress, regValue);
+            }
+            else
+            {
+                InvalidateRegisterCache();
+            }
+        }
+    }
+
+    uint8_t cacheReg(uint8_t regAddress, uint8_t regValue)
+    {
+        if (regAddress == DS3231_REG_CONTROL)
+        {
+            // CONV clears itself when the conversion is done
+            regValue &= ~_BV(DS3231_CONV);
+            _controlCache = regValue;
+            _controlCached = true;
+        }
+        else
+        {
+            // the flags are only changed by writing a zero, so they are 
+            // kept as ones to not clear any that were set since caching,
+            // BSY is read only
+            regValue |= (DS3231_AIFMASK | _BV(DS3231_OSF));
+            regValue &= ~_BV(DS3231_BSY);
+            _statusCache = regValue;
+            _statusCached = true;
+        }
+        return regValue;
+    }
+
     uint8_t getReg(uint8_t regAddress)
     {
         _wire.beginTransmission(DS3231_ADDRESS);
@@ -681,3 +1227,13 @@ protected:
 
 };
 
+template<class T_WIRE_METHOD> struct RtcCapabilities<RtcDS3231<T_WIRE_METHOD>>
+{
+    static const bool HasAlarms = true;
+    static const bool HasTimer = false;
+    static const bool HasTemperature = true;
+    static const bool HasAgingOffset = true;
+    static const bool HasMemory = false;
+    static const uint16_t MemorySize = 0;
+};
+
@@ -27,6 +27,7 @@ License along with Rtc.  If not, see
 #pragma once
 
 #include "RtcDS3231.h"
+#include "RtcCapabilities.h"
 
 // DS3232 is the same as the DS3231 except it has SRAM
 //
@@ -70,55 +71,93 @@ public:
 
     uint8_t SetMemory(uint8_t memoryAddress, const uint8_t* pValue, uint8_t countBytes)
     {
-        uint8_t address = memoryAddress + DS3232_REG_SRAMFIRST;
+        uint16_t address = memoryAddress + DS3232_REG_SRAMFIRST;
         uint8_t countWritten = 0;
-        if (address <= DS3232_REG_SRAMLAST)
+
+        // the register address takes one byte of each transaction
+        while (countBytes > 0 && address <= DS3232_REG_SRAMLAST)
         {
+            size_t countChunk = 0;
+
             this->_wire.beginTransmission(DS3232_ADDRESS);
-            this->_wire.write(address);
+            this->_wire.write(static_cast<uint8_t>(address));
 
-            while (countBytes > 0 && address <= DS3232_REG_SRAMLAST)
+            while (countBytes > 0 && 
+                address <= DS3232_REG_SRAMLAST &&
+                countChunk < (RTC_WIRE_BUFFER_SIZE - 1))
             {
                 this->_wire.write(*pValue++);
                 address++;
                 countBytes--;
-                countWritten++;
+                countChunk++;
             }
 
             this->_lastError = this->_wire.endTransmission();
+            if (this->_lastError != Rtc_Wire_Error_None)
+            {
+                break;
+            }
+            countWritten += countChunk;
         }
         return countWritten;
     }
 
     size_t GetMemory(uint8_t memoryAddress, uint8_t* pValue, size_t countBytes)
     {
-        uint8_t address = memoryAddress + DS3232_REG_SRAMFIRST;
+        uint16_t address = memoryAddress + DS3232_REG_SRAMFIRST;
         size_t countRead = 0;
         if (address <= DS3232_REG_SRAMLAST)
         {
-            if (countBytes > DS3232_REG_SRAMSIZE)
+            if (countBytes > static_cast<size_t>(DS3232_REG_SRAMLAST - address + 1))
             {
-                countBytes = DS3232_REG_SRAMSIZE;
+                countBytes = DS3232_REG_SRAMLAST - address + 1;
             }
 
             this->_wire.beginTransmission(DS3232_ADDRESS);
-            this->_wire.write(address);
+            this->_wire.write(static_cast<uint8_t>(address));
             this->_lastError = this->_wire.endTransmission();
             if (this->_lastError != Rtc_Wire_Error_None)
             {
                 return 0;
             }
 
-            countRead = this->_wire.requestFrom(DS3232_ADDRESS, countBytes);
-            countBytes = countRead;
-
-            while (countBytes-- > 0)
+            // the register address auto increments, so each following
+            // request continues where the last left off
+            while (countBytes > 0)
             {
-                *pValue++ = this->_wire.read();
+                // countBytes was already limited to the memory size, which
+                // keeps the chunk within the uint8_t count of requestFrom
+                size_t countChunk = (countBytes < RTC_WIRE_BUFFER_SIZE) ? countBytes : RTC_WIRE_BUFFER_SIZE;
+                size_t countReceived = this->_wire.requestFrom(DS3232_ADDRESS, static_cast<uint8_t>(countChunk));
+
+                for (size_t index = 0; index < countReceived; index++)
+                {
+                    *pValue++ = this->_wire.read();
+                }
+
+                countRead += countReceived;
+                countBytes -= countReceived;
+
+                if (countReceived != countChunk)
+                {
+                    this->_lastError = Rtc_Wire_Error_Unspecific;
+                    break;
+                }
             }
         }
 
         return countRead;
     }
 
-};
\ No newline at end of file
+};
+
+template<class T_WIRE_METHOD> struct RtcCapabilities<RtcDS3232<T_WIRE_METHOD>>
+{
+    static const bool HasAlarms = true;
+    static const bool HasTimer = false;
+    static const bool HasTemperature = true;
+    static const bool HasAgingOffset = true;
+    static const bool HasMemory = true;
+    static const uint16_t MemorySize = DS3232_REG_SRAMLAST - DS3232_REG_SRAMFIRST + 1;
+};
+
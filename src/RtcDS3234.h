@@ -30,6 +30,7 @@ License along with Rtc.  If not, see
 #include <SPI.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCapabilities.h"
 #include "RtcTemperature.h"
 
 
@@ -255,6 +256,166 @@ enum DS3234AlarmFlag
     DS3234AlarmFlag_AlarmBoth = 0x03,
 };
 
+enum DS3234ConversionState
+{
+    DS3234ConversionState_Idle,
+    // an automatic conversion is running, ours is started once it is done
+    DS3234ConversionState_WaitingForBusy,
+    DS3234ConversionState_Converting,
+    DS3234ConversionState_Complete,
+    DS3234ConversionState_Timeout,
+};
+
+const uint16_t DS3234_CONVERSION_POLL_INTERVAL_MS = 10;
+const uint16_t DS3234_CONVERSION_TIMEOUT_MS = 500; // a busy wait plus our own conversion
+
+const size_t DS3234_REG_SNAPSHOT_SIZE = 0x13; // timedate through temp
+
+// the decoding of the date and time and the alarm registers, shared by
+// RtcDS3234 and DS3234Snapshot so they always agree
+class DS3234Registers
+{
+public:
+    // regs - starting at DS3234_REG_TIMEDATE
+    static RtcDateTime DecodeDateTime(const uint8_t* regs)
+    {
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+        uint8_t minute = BcdToUint8(regs[1]);
+        uint8_t hour = BcdToBin24Hour(regs[2]);
+        // regs[3] day of week is thrown away as we calculate it
+        uint8_t dayOfMonth = BcdToUint8(regs[4]);
+        uint8_t monthRaw = regs[5];
+        uint16_t year = BcdToUint8(regs[6]) + 2000;
+
+        if (monthRaw & _BV(7)) // century wrap flag
+        {
+            year += 100;
+        }
+        uint8_t month = BcdToUint8(monthRaw & 0x7f);
+
+        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    }
+
+    // regs - starting at DS3234_REG_ALARMONE
+    static DS3234AlarmOne DecodeAlarmOne(const uint8_t* regs)
+    {
+        uint8_t flags = (regs[0] & 0x80) >> 7;
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+
+        flags |= (regs[1] & 0x80) >> 6;
+        uint8_t minute = BcdToUint8(regs[1] & 0x7F);
+
+        flags |= (regs[2] & 0x80) >> 5;
+        uint8_t hour = BcdToBin24Hour(regs[2] & 0x7f);
+
+        flags |= (regs[3] & 0xc0) >> 3;
+        uint8_t dayOf = BcdToUint8(regs[3] & 0x3f);
+
+        if (flags == DS3234AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
+        {
+            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+        }
+
+        return DS3234AlarmOne(dayOf, hour, minute, second, (DS3234AlarmOneControl)flags);
+    }
+
+    // regs - starting at DS3234_REG_ALARMTWO
+    static DS3234AlarmTwo DecodeAlarmTwo(const uint8_t* regs)
+    {
+        uint8_t flags = (regs[0] & 0x80) >> 7;
+        uint8_t minute = BcdToUint8(regs[0] & 0x7F);
+
+        flags |= (regs[1] & 0x80) >> 6;
+        uint8_t hour = BcdToBin24Hour(regs[1] & 0x7f);
+
+        flags |= (regs[2] & 0xc0) >> 4;
+        uint8_t dayOf = BcdToUint8(regs[2] & 0x3f);
+
+        if (flags == DS3234AlarmTwoControl_HoursMinutesDayOfWeekMatch)
+        {
+            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
+        }
+
+        return DS3234AlarmTwo(dayOf, hour, minute, (DS3234AlarmTwoControl)flags);
+    }
+};
+
+// all the registers from the time through the temperature, as read at
+// once by RtcDS3234::GetSnapshot(), with the same decoding as the 
+// individual Get methods
+class DS3234Snapshot
+{
+public:
+    DS3234Snapshot()
+    {
+        memset(_regs, 0, sizeof(_regs));
+    }
+
+    RtcDateTime DateTime() const
+    {
+        return DS3234Registers::DecodeDateTime(_regs + DS3234_REG_TIMEDATE);
+    }
+
+    DS3234AlarmOne AlarmOne() const
+    {
+        return DS3234Registers::DecodeAlarmOne(_regs + DS3234_REG_ALARMONE);
+    }
+
+    DS3234AlarmTwo AlarmTwo() const
+    {
+        return DS3234Registers::DecodeAlarmTwo(_regs + DS3234_REG_ALARMTWO);
+    }
+
+    uint8_t Control() const
+    {
+        return _regs[DS3234_REG_CONTROL];
+    }
+
+    uint8_t Status() const
+    {
+        return _regs[DS3234_REG_STATUS];
+    }
+
+    bool IsDateTimeValid() const
+    {
+        return !(Status() & _BV(DS3234_OSF));
+    }
+
+    bool IsRunning() const
+    {
+        return !(Control() & _BV(DS3234_EOSC));
+    }
+
+    DS3234AlarmFlag AlarmsTriggeredFlags() const
+    {
+        return (DS3234AlarmFlag)(Status() & DS3234_AIFMASK);
+    }
+
+    int8_t AgingOffset() const
+    {
+        return _regs[DS3234_REG_AGING];
+    }
+
+    RtcTemperature Temperature() const
+    {
+        return RtcTemperature(_regs[DS3234_REG_TEMP], _regs[DS3234_REG_TEMP + 1]);
+    }
+
+    // the raw registers, indexed by register address
+    const uint8_t* Registers() const
+    {
+        return _regs;
+    }
+
+protected:
+    uint8_t _regs[DS3234_REG_SNAPSHOT_SIZE];
+
+    template<class T_SPI_METHOD> friend class RtcDS3234;
+};
+
+// the largest block staged on the stack for a single SPI transfer call
+const uint8_t DS3234_SPI_BUFFER_SIZE = 32;
+
 const SPISettings c_Ds3234SpiSettings(4000000, MSBFIRST, SPI_MODE3); // CPHA must be used, so mode 1 or mode 3 are valid
 
 template<class T_SPI_METHOD> class RtcDS3234
@@ -262,7 +423,19 @@ template<class T_SPI_METHOD> class RtcDS3234
 public:
     RtcDS3234(T_SPI_METHOD& spi, uint8_t csPin) :
         _spi(spi),
-        _csPin(csPin)
+        _csPin(csPin),
+        _regCacheEnabled(false),
+        _controlCached(false),
+        _statusCached(false),
+        _controlCache(0),
+        _statusCache(0),
+        _convState(DS3234ConversionState_Idle),
+        _convPollIntervalMs(DS3234_CONVERSION_POLL_INTERVAL_MS),
+        _convTimeoutMs(DS3234_CONVERSION_TIMEOUT_MS),
+        _convStartMs(0),
+        _convPollLastMs(0),
+        _sramAddress(0),
+        _sramAddressKnown(false)
     {
     }
 
@@ -272,6 +445,31 @@ public:
         pinMode(_csPin, OUTPUT);
     }
 
+    // the SPI bus doesn't report errors, this is always 
+    // Rtc_Wire_Error_None so generic code can check it
+    uint8_t LastError()
+    {
+        return Rtc_Wire_Error_None;
+    }
+
+    // cache the control and status registers so that changing the 
+    // configuration only writes them rather than reading them first
+    // only use when nothing else changes the configuration of the RTC,
+    // otherwise call InvalidateRegisterCache() after it has
+    void EnableRegisterCache(bool enable)
+    {
+        _regCacheEnabled = enable;
+        InvalidateRegisterCache();
+    }
+
+    // the next configuration change will read the registers again
+    void InvalidateRegisterCache()
+    {
+        _controlCached = false;
+        _statusCached = false;
+        _sramAddressKnown = false;
+    }
+
     bool IsDateTimeValid()
     {
         uint8_t status = getReg(DS3234_REG_STATUS);
@@ -286,7 +484,7 @@ public:
 
     void SetIsRunning(bool isRunning)
     {
-        uint8_t creg = getReg(DS3234_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3234_REG_CONTROL);
         if (isRunning)
         {
             creg &= ~_BV(DS3234_EOSC);
@@ -295,24 +493,23 @@ public:
         {
             creg |= _BV(DS3234_EOSC);
         }
-        setReg(DS3234_REG_CONTROL, creg);
+        setConfigReg(DS3234_REG_CONTROL, creg);
     }
 
     void SetDateTime(const RtcDateTime& dt)
     {
         // clear the invalid flag
-        uint8_t status = getReg(DS3234_REG_STATUS);
+        uint8_t status = getConfigReg(DS3234_REG_STATUS);
         status &= ~_BV(DS3234_OSF); // clear the flag
-        setReg(DS3234_REG_STATUS, status);
+        setConfigReg(DS3234_REG_STATUS, status);
 
         // set the date time
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-        _spi.transfer(DS3234_REG_TIMEDATE | DS3234_REG_WRITE_FLAG);
+        uint8_t buffer[8];
 
-        _spi.transfer(Uint8ToBcd(dt.Second()));
-        _spi.transfer(Uint8ToBcd(dt.Minute()));
-        _spi.transfer(Uint8ToBcd(dt.Hour())); // 24 hour mode only
+        buffer[0] = DS3234_REG_TIMEDATE | DS3234_REG_WRITE_FLAG;
+        buffer[1] = Uint8ToBcd(dt.Second());
+        buffer[2] = Uint8ToBcd(dt.Minute());
+        buffer[3] = Uint8ToBcd(dt.Hour()); // 24 hour mode only
 
         uint8_t year = dt.Year() - 2000;
         uint8_t centuryFlag = 0;
@@ -327,49 +524,36 @@ public:
         // convert our Day of Week to Rtc Day of Week
         uint8_t rtcDow = RtcDateTime::ConvertDowToRtc(dt.DayOfWeek());
 
-        _spi.transfer(Uint8ToBcd(rtcDow));
+        buffer[4] = Uint8ToBcd(rtcDow);
 
-        _spi.transfer(Uint8ToBcd(dt.Day()));
-        _spi.transfer(Uint8ToBcd(dt.Month()) | centuryFlag);
-        _spi.transfer(Uint8ToBcd(year));
-        UnselectChip();
-        _spi.endTransaction();
+        buffer[5] = Uint8ToBcd(dt.Day());
+        buffer[6] = Uint8ToBcd(dt.Month()) | centuryFlag;
+        buffer[7] = Uint8ToBcd(year);
+
+        transferBlock(buffer, sizeof(buffer));
     }
 
     RtcDateTime GetDateTime()
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-
-        _spi.transfer(DS3234_REG_TIMEDATE);
-
-        uint8_t second = BcdToUint8(_spi.transfer(0));
-        uint8_t minute = BcdToUint8(_spi.transfer(0));
-        uint8_t hour = BcdToBin24Hour(_spi.transfer(0));
+        uint8_t regs[7];
 
-        _spi.transfer(0); // throwing away day of week as we calculate it
-
-        uint8_t dayOfMonth = BcdToUint8(_spi.transfer(0));
-        uint8_t monthRaw = _spi.transfer(0);
-        uint16_t year = BcdToUint8(_spi.transfer(0)) + 2000;
-
-        UnselectChip();
-        _spi.endTransaction();
+        readRegs(DS3234_REG_TIMEDATE, regs, sizeof(regs));
 
-        if (monthRaw & _BV(7)) // century wrap flag
-        {
-            year += 100;
-        }
-        uint8_t month = BcdToUint8(monthRaw & 0x7f);
+        return DS3234Registers::DecodeDateTime(regs);
+    }
 
-        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    // read just the seconds, a much shorter transfer than GetDateTime()
+    // for polling until the seconds change, see RtcSecondEdge
+    uint8_t GetSecond()
+    {
+        return BcdToUint8(getReg(DS3234_REG_TIMEDATE) & 0x7F);
     }
 
     RtcTemperature GetTemperature()
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-        _spi.transfer(DS3234_REG_TEMP);
+        uint8_t regs[2];
+
+        readRegs(DS3234_REG_TEMP, regs, sizeof(regs));
 
         // Temperature is represented as a 10-bit code with a resolution
         // of 1/4th C and is accessable as a signed 16-bit integer at
@@ -385,18 +569,15 @@ public:
         // For example, at +/- 25.25C, concatenated registers <r11h:r12h> =
         // 256 * (+/- 25+(1/4)) = +/- 6464, or 1940h / E6C0h.
 
-        int8_t  ms = _spi.transfer(0);  // MS byte, signed temperature
-        uint8_t ls = _spi.transfer(0);  // LS byte is r12h
-
-        UnselectChip();
-        _spi.endTransaction();
+        int8_t  ms = regs[0];  // MS byte, signed temperature
+        uint8_t ls = regs[1];  // LS byte is r12h
 
         return RtcTemperature(ms, ls);  // LS byte is r12h
     }
 
     void Enable32kHzPin(bool enable)
     {
-        uint8_t sreg = getReg(DS3234_REG_STATUS);
+        uint8_t sreg = getConfigReg(DS3234_REG_STATUS);
 
         if (enable == true)
         {
@@ -407,12 +588,12 @@ public:
             sreg &= ~_BV(DS3234_EN32KHZ);
         }
 
-        setReg(DS3234_REG_STATUS, sreg);
+        setConfigReg(DS3234_REG_STATUS, sreg);
     }
 
     void SetSquareWavePin(DS3234SquareWavePinMode pinMode)
     {
-        uint8_t creg = getReg(DS3234_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3234_REG_CONTROL);
 
         // clear all relevant bits to a known "off" state
         creg &= ~(DS3234_AIEMASK | _BV(DS3234_BBSQW));
@@ -445,30 +626,28 @@ public:
             break;
         }
 
-        setReg(DS3234_REG_CONTROL, creg);
+        setConfigReg(DS3234_REG_CONTROL, creg);
     }
 
     void SetSquareWavePinClockFrequency(DS3234SquareWaveClock freq)
     {
-        uint8_t creg = getReg(DS3234_REG_CONTROL);
+        uint8_t creg = getConfigReg(DS3234_REG_CONTROL);
 
         creg &= ~DS3234_RSMASK; // Set to 0
         creg |= (freq & DS3234_RSMASK); // Set freq bits
 
-        setReg(DS3234_REG_CONTROL, creg);
+        setConfigReg(DS3234_REG_CONTROL, creg);
     }
 
 
     void SetAlarmOne(const DS3234AlarmOne& alarm)
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-
-        _spi.transfer(DS3234_REG_ALARMONE | DS3234_REG_WRITE_FLAG);
+        uint8_t buffer[5];
 
-        _spi.transfer(Uint8ToBcd(alarm.Second()) | ((alarm.ControlFlags() & 0x01) << 7));
-        _spi.transfer(Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x02) << 6));
-        _spi.transfer(Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x04) << 5)); // 24 hour mode only
+        buffer[0] = DS3234_REG_ALARMONE | DS3234_REG_WRITE_FLAG;
+        buffer[1] = Uint8ToBcd(alarm.Second()) | ((alarm.ControlFlags() & 0x01) << 7);
+        buffer[2] = Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x02) << 6);
+        buffer[3] = Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x04) << 5); // 24 hour mode only
 
         uint8_t rtcDow = alarm.DayOf();
         if (alarm.ControlFlags() == DS3234AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
@@ -476,21 +655,18 @@ public:
             rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
         }
 
-        _spi.transfer(Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x18) << 3));
+        buffer[4] = Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x18) << 3);
 
-        UnselectChip();
-        _spi.endTransaction();
+        transferBlock(buffer, sizeof(buffer));
     }
 
     void SetAlarmTwo(const DS3234AlarmTwo& alarm)
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-
-        _spi.transfer(DS3234_REG_ALARMTWO | DS3234_REG_WRITE_FLAG);
+        uint8_t buffer[4];
 
-        _spi.transfer(Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x01) << 7));
-        _spi.transfer(Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x02) << 6)); // 24 hour mode only
+        buffer[0] = DS3234_REG_ALARMTWO | DS3234_REG_WRITE_FLAG;
+        buffer[1] = Uint8ToBcd(alarm.Minute()) | ((alarm.ControlFlags() & 0x01) << 7);
+        buffer[2] = Uint8ToBcd(alarm.Hour()) | ((alarm.ControlFlags() & 0x02) << 6); // 24 hour mode only
 
         // convert our Day of Week to Rtc Day of Week if needed
         uint8_t rtcDow = alarm.DayOf();
@@ -499,74 +675,27 @@ public:
             rtcDow = RtcDateTime::ConvertDowToRtc(rtcDow);
         }
         
-        _spi.transfer(Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x0c) << 4));
+        buffer[3] = Uint8ToBcd(rtcDow) | ((alarm.ControlFlags() & 0x0c) << 4);
 
-        UnselectChip();
-        _spi.endTransaction();
+        transferBlock(buffer, sizeof(buffer));
     }
 
     DS3234AlarmOne GetAlarmOne()
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-
-        _spi.transfer(DS3234_REG_ALARMONE);
-  
-        uint8_t raw = _spi.transfer(0);
-        uint8_t flags = (raw & 0x80) >> 7;
-        uint8_t second = BcdToUint8(raw & 0x7F);
-
-        raw = _spi.transfer(0);
-        flags |= (raw & 0x80) >> 6;
-        uint8_t minute = BcdToUint8(raw & 0x7F);
-
-        raw = _spi.transfer(0);
-        flags |= (raw & 0x80) >> 5;
-        uint8_t hour = BcdToBin24Hour(raw & 0x7f);
+        uint8_t regs[4];
 
-        raw = _spi.transfer(0);
-        flags |= (raw & 0xc0) >> 3;
-        uint8_t dayOf = BcdToUint8(raw & 0x3f);
+        readRegs(DS3234_REG_ALARMONE, regs, sizeof(regs));
 
-        UnselectChip();
-        _spi.endTransaction();
-
-        if (flags == DS3234AlarmOneControl_HoursMinutesSecondsDayOfWeekMatch)
-        {
-            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
-        }
-
-        return DS3234AlarmOne(dayOf, hour, minute, second, (DS3234AlarmOneControl)flags);
+        return DS3234Registers::DecodeAlarmOne(regs);
     }
 
     DS3234AlarmTwo GetAlarmTwo()
     {
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-
-        _spi.transfer(DS3234_REG_ALARMTWO);
-
-        uint8_t raw = _spi.transfer(0);
-        uint8_t flags = (raw & 0x80) >> 7;
-        uint8_t minute = BcdToUint8(raw & 0x7F);
-
-        raw = _spi.transfer(0);
-        flags |= (raw & 0x80) >> 6;
-        uint8_t hour = BcdToBin24Hour(raw & 0x7f);
+        uint8_t regs[3];
 
-        raw = _spi.transfer(0);
-        flags |= (raw & 0xc0) >> 4;
-        uint8_t dayOf = BcdToUint8(raw & 0x3f);
+        readRegs(DS3234_REG_ALARMTWO, regs, sizeof(regs));
 
-        UnselectChip();
-        _spi.endTransaction();
-
-        if (flags == DS3234AlarmTwoControl_HoursMinutesDayOfWeekMatch)
-        {
-            dayOf = RtcDateTime::ConvertRtcToDow(dayOf);
-        }
-
-        return DS3234AlarmTwo(dayOf, hour, minute, (DS3234AlarmTwoControl)flags);
+        return DS3234Registers::DecodeAlarmTwo(regs);
     }
 
     // Latch must be called after an alarm otherwise it will not
@@ -576,18 +705,18 @@ public:
         uint8_t sreg = getReg(DS3234_REG_STATUS);
         uint8_t alarmFlags = (sreg & DS3234_AIFMASK);
         sreg &= ~DS3234_AIFMASK; // clear the flags
-        setReg(DS3234_REG_STATUS, sreg);
+        setConfigReg(DS3234_REG_STATUS, sreg);
         return (DS3234AlarmFlag)alarmFlags;
     }
 
     void SetTemperatureCompensationRate(DS3234TempCompensationRate rate)
     {
-        uint8_t sreg = getReg(DS3234_REG_STATUS);
+        uint8_t sreg = getConfigReg(DS3234_REG_STATUS);
 
         sreg &= ~DS3234_CRATEMASK;
         sreg |= (rate << DS3234_CRATE0);
 
-        setReg(DS3234_REG_STATUS, sreg);
+        setConfigReg(DS3234_REG_STATUS, sreg);
     }
 
     DS3234TempCompensationRate GetTemperatureCompensationRate()
@@ -596,19 +725,99 @@ public:
         return (sreg & DS3234_CRATEMASK) >> DS3234_CRATE0;
     }
 
+    // when block is true, waits for the conversion to complete using 
+    // the polling interval and timeout of SetTemperatureCompensationPolling()
     void ForceTemperatureCompensationUpdate(bool block)
     {
-        uint8_t creg = getReg(DS3234_REG_CONTROL);
-        creg |= _BV(DS3234_CONV); // Write CONV bit
-        setReg(DS3234_REG_CONTROL, creg);
+        if (!block)
+        {
+            startConversion();
+            return;
+        }
 
-        while (block && (creg & _BV(DS3234_CONV)) != 0)
+        DS3234ConversionState state = StartTemperatureCompensationUpdate();
+        while (isConverting(state))
         {
-            // Block until CONV is 0
-            creg = getReg(DS3234_REG_CONTROL);
+            yield();
+            state = PollTemperatureCompensationUpdate();
         }
     }
 
+    // set how often PollTemperatureCompensationUpdate() will read the device
+    // and how long in total it will wait before reporting a timeout
+    void SetTemperatureCompensationPolling(uint16_t intervalMs, uint16_t timeoutMs)
+    {
+        _convPollIntervalMs = intervalMs;
+        _convTimeoutMs = timeoutMs;
+    }
+
+    // start a temperature conversion without waiting for it, 
+    // if the device is busy with an automatic conversion then ours 
+    // will be started by PollTemperatureCompensationUpdate() once it is done
+    DS3234ConversionState StartTemperatureCompensationUpdate()
+    {
+        if (isConverting(_convState))
+        {
+            return _convState;
+        }
+
+        _convStartMs = millis();
+        _convPollLastMs = _convStartMs;
+
+        uint8_t sreg = getReg(DS3234_REG_STATUS);
+        if (sreg & _BV(DS3234_BSY))
+        {
+            _convState = DS3234ConversionState_WaitingForBusy;
+        }
+        else
+        {
+            _convState = startConversion();
+        }
+        return _convState;
+    }
+
+    // call often after StartTemperatureCompensationUpdate(), the device is
+    // only read once per polling interval, the returned state will
+    // be Complete, Timeout when it is no longer converting
+    DS3234ConversionState PollTemperatureCompensationUpdate()
+    {
+        if (!isConverting(_convState))
+        {
+            return _convState;
+        }
+
+        uint32_t msNow = millis();
+        if ((msNow - _convPollLastMs) < _convPollIntervalMs)
+        {
+            return _convState;
+        }
+        _convPollLastMs = msNow;
+
+        if (_convState == DS3234ConversionState_WaitingForBusy)
+        {
+            uint8_t sreg = getReg(DS3234_REG_STATUS);
+            if ((sreg & _BV(DS3234_BSY)) == 0)
+            {
+                _convState = startConversion();
+            }
+        }
+        else
+        {
+            // the cache never holds CONV, so always read it
+            uint8_t creg = getReg(DS3234_REG_CONTROL);
+            if ((creg & _BV(DS3234_CONV)) == 0)
+            {
+                _convState = DS3234ConversionState_Complete;
+            }
+        }
+
+        if (isConverting(_convState) && (msNow - _convStartMs) >= _convTimeoutMs)
+        {
+            _convState = DS3234ConversionState_Timeout;
+        }
+        return _convState;
+    }
+
     int8_t GetAgingOffset()
     {
         return getReg(DS3234_REG_AGING);
@@ -619,6 +828,17 @@ public:
         setReg(DS3234_REG_AGING, value);
     }
 
+    // read all the registers from the time through the temperature
+    // in one transaction
+    DS3234Snapshot GetSnapshot()
+    {
+        DS3234Snapshot snapshot;
+
+        readRegs(DS3234_REG_TIMEDATE, snapshot._regs, DS3234_REG_SNAPSHOT_SIZE);
+
+        return snapshot;
+    }
+
     void SetMemory(uint8_t memoryAddress, uint8_t value)
     {
         SetMemory(memoryAddress, &value, 1);
@@ -636,49 +856,87 @@ public:
     uint8_t SetMemory(uint8_t memoryAddress, const uint8_t* pValue, uint8_t countBytes)
     {
         uint8_t countWritten = 0;
-
-        setReg(DS3234_REG_RAM_ADDRESS, memoryAddress);
+        uint8_t buffer[DS3234_SPI_BUFFER_SIZE];
 
         _spi.beginTransaction(c_Ds3234SpiSettings);
         SelectChip();
-        _spi.transfer(DS3234_REG_RAM_DATA | DS3234_REG_WRITE_FLAG);
+        if (isSramAddress(memoryAddress))
+        {
+            // continue from where the SRAM address was left
+            _spi.transfer(DS3234_REG_RAM_DATA | DS3234_REG_WRITE_FLAG);
+        }
+        else
+        {
+            // the data register follows the address register, and it
+            // doesn't move on while bursting, so both are written at once
+            buffer[0] = DS3234_REG_RAM_ADDRESS | DS3234_REG_WRITE_FLAG;
+            buffer[1] = memoryAddress;
+            _spi.transfer(buffer, 2);
+        }
 
+        // the block transfer replaces what is sent with what is received
+        // so the data is staged through a buffer 
         while (countBytes > 0)
         {
-            _spi.transfer(*pValue++);
-            
-            countBytes--;
-            countWritten++;
+            uint8_t count = (countBytes < sizeof(buffer)) ? countBytes : sizeof(buffer);
+
+            memcpy(buffer, pValue, count);
+            _spi.transfer(buffer, count);
+
+            pValue += count;
+            countBytes -= count;
+            countWritten += count;
         }
 
         UnselectChip();
         _spi.endTransaction();
 
+        setSramAddress(memoryAddress + countWritten);
+
         return countWritten;
     }
 
     uint8_t GetMemory(uint8_t memoryAddress, uint8_t* pValue, uint8_t countBytes)
     {
         // set address to read from
-        setReg(DS3234_REG_RAM_ADDRESS, memoryAddress);
-
-        _spi.beginTransaction(c_Ds3234SpiSettings);
-        SelectChip();
-        _spi.transfer(DS3234_REG_RAM_DATA);
+        if (!isSramAddress(memoryAddress))
+        {
+            setReg(DS3234_REG_RAM_ADDRESS, memoryAddress);
+        }
 
         // read the data
-        uint8_t countRead = 0;
+        readRegs(DS3234_REG_RAM_DATA, pValue, countBytes);
+
+        setSramAddress(memoryAddress + countBytes);
+        return countBytes;
+    }
 
-        while (countBytes-- > 0)
+    // sequential access to the SRAM like a file, each call continues from 
+    // where the last SRAM access ended without sending the address again, 
+    // the address wraps from the end of the SRAM to the start
+    void SeekMemory(uint8_t memoryAddress)
+    {
+        if (memoryAddress != _sramAddress)
         {
-            *pValue++ = _spi.transfer(0);
-            countRead++;
+            _sramAddress = memoryAddress;
+            _sramAddressKnown = false;
         }
+    }
 
-        UnselectChip();
-        _spi.endTransaction();
+    // the SRAM address the next ReadMemory() or WriteMemory() will use
+    uint8_t TellMemory() const
+    {
+        return _sramAddress;
+    }
 
-        return countRead;
+    uint8_t ReadMemory(uint8_t* pValue, uint8_t countBytes)
+    {
+        return GetMemory(_sramAddress, pValue, countBytes);
+    }
+
+    uint8_t WriteMemory(const uint8_t* pValue, uint8_t countBytes)
+    {
+        return SetMemory(_sramAddress, pValue, countBytes);
     }
 
 private:
@@ -694,28 +952,153 @@ private:
         digitalWrite(_csPin, HIGH);
     }
 
+    bool _regCacheEnabled;
+    bool _controlCached;
+    bool _statusCached;
+    uint8_t _controlCache;
+    uint8_t _statusCache;
+
+    DS3234ConversionState _convState;
+    uint16_t _convPollIntervalMs;
+    uint16_t _convTimeoutMs;
+    uint32_t _convStartMs;
+    uint32_t _convPollLastMs;
+
+    // the SRAM address register auto increments on every data access, so 
+    // once it has been set, where it is can be tracked rather than resent
+    uint8_t _sramAddress;
+    bool _sramAddressKnown;
+
+    bool isSramAddress(uint8_t memoryAddress) const
+    {
+        return (_sramAddressKnown && _sramAddress == memoryAddress);
+    }
+
+    void setSramAddress(uint8_t memoryAddress)
+    {
+        _sramAddress = memoryAddress;
+        _sramAddressKnown = true;
+    }
+
+    static bool isConverting(DS3234ConversionState state)
+    {
+        return (state == DS3234ConversionState_WaitingForBusy ||
+            state == DS3234ConversionState_Converting);
+    }
+
+    DS3234ConversionState startConversion()
+    {
+        uint8_t creg = getConfigReg(DS3234_REG_CONTROL);
+        creg |= _BV(DS3234_CONV); // Write CONV bit
+        setConfigReg(DS3234_REG_CONTROL, creg);
+        return DS3234ConversionState_Converting;
+    }
+
+    // read a register to change its configuration bits, 
+    // using the cache when enabled
+    uint8_t getConfigReg(uint8_t regAddress)
+    {
+        if (_regCacheEnabled)
+        {
+            if (regAddress == DS3234_REG_CONTROL && _controlCached)
+            {
+                return _controlCache;
+            }
+            if (regAddress == DS3234_REG_STATUS && _statusCached)
+            {
+                return _statusCache;
+            }
+        }
+
+        uint8_t regValue = getReg(regAddress);
+        if (_regCacheEnabled)
+        {
+            regValue = cacheReg(regAddress, regValue);
+        }
+        return regValue;
+    }
+
+    void setConfigReg(uint8_t regAddress, uint8_t regValue)
+    {
+        setReg(regAddress, regValue);
+        if (_regCacheEnabled)
+        {
+            cacheReg(regAddress, regValue);
+        }
+    }
+
+    uint8_t cacheReg(uint8_t regAddress, uint8_t regValue)
+    {
+        if (regAddress == DS3234_REG_CONTROL)
+        {
+            // CONV clears itself when the conversion is done
+            regValue &= ~_BV(DS3234_CONV);
+            _controlCache = regValue;
+            _controlCached = true;
+        }
+        else
+        {
+            // the flags are only changed by writing a zero, so they are 
+            // kept as ones to not clear any that were set since caching,
+            // BSY is read only
+            regValue |= (DS3234_AIFMASK | _BV(DS3234_OSF));
+            regValue &= ~_BV(DS3234_BSY);
+            _statusCache = regValue;
+            _statusCached = true;
+        }
+        return regValue;
+    }
+
     uint8_t getReg(uint8_t regAddress)
     {
-        uint8_t regValue;
+        uint8_t buffer[2] = { regAddress, 0 };
+
+        transferBlock(buffer, sizeof(buffer));
+
+        return buffer[1];
+    }
+
+    void setReg(uint8_t regAddress, uint8_t regValue)
+    {
+        uint8_t buffer[2] = { static_cast<uint8_t>(regAddress | DS3234_REG_WRITE_FLAG), regValue };
+
+        transferBlock(buffer, sizeof(buffer));
+    }
+
+    // a whole transaction as one block transfer, buffer[0] is the register
+    // address and the buffer is replaced with what was received
+    void transferBlock(uint8_t* buffer, size_t count)
+    {
         _spi.beginTransaction(c_Ds3234SpiSettings);
         SelectChip();
-        _spi.transfer(regAddress);
-        regValue = _spi.transfer(0);
+        _spi.transfer(buffer, count);
         UnselectChip();
         _spi.endTransaction();
-
-        return regValue;
     }
 
-    void setReg(uint8_t regAddress, uint8_t regValue)
+    // read count registers starting at regAddress directly into regs
+    void readRegs(uint8_t regAddress, uint8_t* regs, size_t count)
     {
+        // zeros are clocked out while reading
+        memset(regs, 0, count);
+
         _spi.beginTransaction(c_Ds3234SpiSettings);
         SelectChip();
-        _spi.transfer(regAddress | DS3234_REG_WRITE_FLAG);
-        _spi.transfer(regValue);
+        _spi.transfer(regAddress);
+        _spi.transfer(regs, count);
         UnselectChip();
         _spi.endTransaction();
     }
 
 };
 
+template<class T_SPI_METHOD> struct RtcCapabilities<RtcDS3234<T_SPI_METHOD>>
+{
+    static const bool HasAlarms = true;
+    static const bool HasTimer = false;
+    static const bool HasTemperature = true;
+    static const bool HasAgingOffset = true;
+    static const bool HasMemory = true;
+    static const uint16_t MemorySize = 256;
+};
+
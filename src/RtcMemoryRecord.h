@@ -0,0 +1,173 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+
+// A record of V_SIZE bytes kept in RAM while it is changed over many calls,
+// then only the span of bytes that were changed is written back to the
+// memory of the RTC in one transfer
+//
+// Works with any RTC that has SetMemory and GetMemory taking an
+// address, pointer, and count, like the DS3234, DS3232, and DS1307
+//
+// Sample...
+//    RtcMemoryRecord<16> record(32);
+//    record.Load(Rtc);
+//    record.Read(4, bootCount);
+//    bootCount++;
+//    record.Write(4, bootCount);
+//    ...
+//    record.Store(Rtc);
+//
+template<uint8_t V_SIZE> class RtcMemoryRecord
+{
+public:
+    // memoryAddress - where the record is in the RTC memory
+    RtcMemoryRecord(uint8_t memoryAddress) :
+        _memoryAddress(memoryAddress)
+    {
+        memset(_data, 0, sizeof(_data));
+        clearDirty();
+    }
+
+    // read the whole record from the RTC, throwing away any changes
+    // returns - the number of bytes read, less than V_SIZE if the read
+    //     failed and the record does not match the RTC
+    template<class T_RTC> uint8_t Load(T_RTC& rtc)
+    {
+        uint8_t countRead = rtc.GetMemory(_memoryAddress, _data, V_SIZE);
+        clearDirty();
+        return countRead;
+    }
+
+    // write the changed span of the record to the RTC, bytes that failed
+    // to be written stay changed so a later Store() will retry them
+    // returns - the number of bytes written
+    template<class T_RTC> uint8_t Store(T_RTC& rtc)
+    {
+        if (!IsDirty())
+        {
+            return 0;
+        }
+
+        uint8_t count = _dirtyEnd - _dirtyStart;
+        uint8_t written = rtc.SetMemory(_memoryAddress + _dirtyStart, 
+            _data + _dirtyStart, 
+            count);
+        _dirtyStart += written;
+        if (!IsDirty())
+        {
+            clearDirty();
+        }
+        return written;
+    }
+
+    bool IsDirty() const
+    {
+        return (_dirtyEnd > _dirtyStart);
+    }
+
+    uint8_t Read(uint8_t offset, uint8_t* pValue, uint8_t countBytes) const
+    {
+        countBytes = clampCount(offset, countBytes);
+        memcpy(pValue, _data + offset, countBytes);
+        return countBytes;
+    }
+
+    // only bytes that actually change mark the record as needing a Store()
+    uint8_t Write(uint8_t offset, const uint8_t* pValue, uint8_t countBytes)
+    {
+        countBytes = clampCount(offset, countBytes);
+
+        for (uint8_t index = offset; index < offset + countBytes; index++)
+        {
+            uint8_t value = *pValue++;
+            if (_data[index] != value)
+            {
+                _data[index] = value;
+                if (index < _dirtyStart)
+                {
+                    _dirtyStart = index;
+                }
+                if (index >= _dirtyEnd)
+                {
+                    _dirtyEnd = index + 1;
+                }
+            }
+        }
+        return countBytes;
+    }
+
+    // read a value of any plain type, like uint16_t or a struct
+    template<typename T> uint8_t Read(uint8_t offset, T& value) const
+    {
+        return Read(offset, reinterpret_cast<uint8_t*>(&value), sizeof(T));
+    }
+
+    template<typename T> uint8_t Write(uint8_t offset, const T& value)
+    {
+        return Write(offset, reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    uint8_t Get(uint8_t offset) const
+    {
+        uint8_t value = 0;
+        Read(offset, &value, 1);
+        return value;
+    }
+
+    void Set(uint8_t offset, uint8_t value)
+    {
+        Write(offset, &value, 1);
+    }
+
+protected:
+    uint8_t _memoryAddress;
+    uint8_t _dirtyStart; // first changed byte
+    uint8_t _dirtyEnd; // one past the last changed byte
+    uint8_t _data[V_SIZE];
+
+    void clearDirty()
+    {
+        _dirtyStart = V_SIZE;
+        _dirtyEnd = 0;
+    }
+
+    uint8_t clampCount(uint8_t offset, uint8_t countBytes) const
+    {
+        if (offset >= V_SIZE)
+        {
+            return 0;
+        }
+        if (countBytes > V_SIZE - offset)
+        {
+            countBytes = V_SIZE - offset;
+        }
+        return countBytes;
+    }
+};
@@ -29,6 +29,8 @@ License along with Rtc.  If not, see
 #include <Arduino.h>
 #include "RtcUtility.h"
 #include "RtcDateTime.h"
+#include "RtcCapabilities.h"
+#include "RtcWireAsyncRead.h"
 
 
 //I2C Slave Address
@@ -254,24 +256,42 @@ public:
             return RtcDateTime(0);
         }
 
-        uint8_t second = BcdToUint8(_wire.read() & 0x7F);
-        uint8_t minute = BcdToUint8(_wire.read() & 0x7F);
-        uint8_t hour = BcdToBin24Hour(_wire.read() & 0x3F);
-        uint8_t dayOfMonth = BcdToUint8(_wire.read() & 0x3F);
-        _wire.read();  // throwing away day of week as we calculate it
-        uint8_t monthRaw = _wire.read();
-        uint16_t year = BcdToUint8(_wire.read()) + 2000;
-
-        if (monthRaw & _BV(7)) // century wrap flag
+        uint8_t regs[PCF8563_REG_TIMEDATE_SIZE];
+        for (size_t index = 0; index < PCF8563_REG_TIMEDATE_SIZE; index++)
         {
-            year += 100;
+            regs[index] = _wire.read();
         }
-        uint8_t month = BcdToUint8(monthRaw & 0x1F);
 
+        return decodeDateTime(regs);
+    }
 
-        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    // read just the seconds, a much shorter transfer than GetDateTime()
+    // for polling until the seconds change, see RtcSecondEdge
+    uint8_t GetSecond()
+    {
+        // without the integrity flag
+        return BcdToUint8(getReg(PCF8563_REG_TIMEDATE) & 0x7F);
+    }
+
+    // start reading the date and time in steps, 
+    // call request.Poll() until it completes, see RtcWireAsyncRead
+    // return - false if the request is busy
+    template<uint8_t V_SIZE> bool StartGetDateTime(RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        return request.Start(PCF8563_ADDRESS, PCF8563_REG_TIMEDATE, PCF8563_REG_TIMEDATE_SIZE);
     }
 
+    // the date and time from a completed StartGetDateTime() request
+    template<uint8_t V_SIZE> RtcDateTime GetDateTime(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        if (!isRequestComplete(request))
+        {
+            return RtcDateTime(0);
+        }
+        return decodeDateTime(request.Data());
+    }
+
+
     void SetSquareWavePin(PCF8563SquareWavePinMode pinMode)
     {
         setReg(PCF8563_REG_CLKOUT_CONTROL, pinMode);
@@ -390,6 +410,39 @@ private:
     T_WIRE_METHOD& _wire;
     uint8_t _lastError;
 
+    static RtcDateTime decodeDateTime(const uint8_t* regs)
+    {
+        uint8_t second = BcdToUint8(regs[0] & 0x7F);
+        uint8_t minute = BcdToUint8(regs[1] & 0x7F);
+        uint8_t hour = BcdToBin24Hour(regs[2] & 0x3F);
+        uint8_t dayOfMonth = BcdToUint8(regs[3] & 0x3F);
+        // regs[4] day of week is thrown away as we calculate it
+        uint8_t monthRaw = regs[5];
+        uint16_t year = BcdToUint8(regs[6]) + 2000;
+
+        if (monthRaw & _BV(7)) // century wrap flag
+        {
+            year += 100;
+        }
+        uint8_t month = BcdToUint8(monthRaw & 0x1F);
+
+        return RtcDateTime(year, month, dayOfMonth, hour, minute, second);
+    }
+
+    template<uint8_t V_SIZE> bool isRequestComplete(const RtcWireAsyncRead<T_WIRE_METHOD, V_SIZE>& request)
+    {
+        _lastError = request.LastError();
+        if (request.State() != RtcAsyncState_Complete)
+        {
+            if (_lastError == Rtc_Wire_Error_None)
+            {
+                _lastError = Rtc_Wire_Error_Unspecific;
+            }
+            return false;
+        }
+        return true;
+    }
+
     uint8_t getReg(uint8_t regAddress)
     {
         _wire.beginTransmission(PCF8563_ADDRESS);
@@ -422,3 +475,13 @@ private:
 
 };
 
+template<class T_WIRE_METHOD> struct RtcCapabilities<RtcPCF8563<T_WIRE_METHOD>>
+{
+    static const bool HasAlarms = true;
+    static const bool HasTimer = true;
+    static const bool HasTemperature = false;
+    static const bool HasAgingOffset = false;
+    static const bool HasMemory = false;
+    static const uint16_t MemorySize = 0;
+};
+
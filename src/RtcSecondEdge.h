@@ -0,0 +1,153 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+
+// the default time to wait for the second to change, a little 
+// longer than a second
+const uint16_t c_SecondEdgeTimeoutMs = 1100;
+
+// the time between polls of the seconds, which is how late 
+// GetDateTime() may see the change
+const uint16_t c_SecondEdgePollUs = 1000;
+
+// Reads and sets the date and time of any of the RTC modules aligned to
+// the moment the seconds change, rather than anywhere within the second
+//
+// The RTCs restart counting the second when the seconds are written, so 
+// setting at the edge of the source second keeps them in phase, and
+// reading at the edge tells the sketch the time to within a few 
+// milliseconds
+//
+class RtcSecondEdge
+{
+public:
+    // wait for the seconds to change by polling the seconds of the RTC, 
+    // then retrieve the new time once
+    // now - [out] the date and time just after the seconds changed
+    // return - false if it timed out, like from a communications error
+    template<class T_RTC> static bool GetDateTime(T_RTC& rtc, 
+        RtcDateTime* now, 
+        uint16_t timeoutMs = c_SecondEdgeTimeoutMs)
+    {
+        uint32_t msStart = millis();
+        uint8_t secondLast = rtc.GetSecond();
+        bool hasLast = (rtc.LastError() == Rtc_Wire_Error_None);
+
+        do
+        {
+            // leave the bus and the rest of the sketch some time
+            yield();
+            delayMicroseconds(c_SecondEdgePollUs);
+
+            uint8_t second = rtc.GetSecond();
+            if (rtc.LastError() != Rtc_Wire_Error_None)
+            {
+                hasLast = false;
+            }
+            else
+            {
+                // ignore changes of time that are not the next second
+                if (hasLast && second == (secondLast + 1) % 60)
+                {
+                    *now = rtc.GetDateTime();
+                    return (rtc.LastError() == Rtc_Wire_Error_None &&
+                        now->Second() == second);
+                }
+                secondLast = second;
+                hasLast = true;
+            }
+        } while (millis() - msStart < timeoutMs);
+
+        return false;
+    }
+
+    // wait for the falling edge of the 1Hz square wave of the RTC on a pin 
+    // and retrieve the new time, this avoids polling the RTC
+    // pin - the input the square wave pin is connected to, already 
+    //     configured for 1Hz
+    // now - [out] the date and time just after the seconds changed
+    // return - false if it timed out or the RTC could not be read
+    template<class T_RTC> static bool GetDateTimeOnPin(T_RTC& rtc, 
+        uint8_t pin,
+        RtcDateTime* now, 
+        uint16_t timeoutMs = c_SecondEdgeTimeoutMs)
+    {
+        uint32_t msStart = millis();
+        int level = digitalRead(pin);
+
+        do
+        {
+            int levelLast = level;
+
+            level = digitalRead(pin);
+            if (levelLast == HIGH && level == LOW)
+            {
+                *now = rtc.GetDateTime();
+                return (rtc.LastError() == Rtc_Wire_Error_None);
+            }
+        } while (millis() - msStart < timeoutMs);
+
+        return false;
+    }
+
+    // set the RTC at the moment the seconds of the source change, waiting
+    // up to a second for it
+    // dt - the date and time from the source, like NTP
+    // msIntoSecond - how far into that second the source was
+    // msCaptured - the millis() when the source was read
+    template<class T_RTC> static void SetDateTime(T_RTC& rtc, 
+        const RtcDateTime& dt, 
+        uint16_t msIntoSecond, 
+        uint32_t msCaptured)
+    {
+        // when the source second started and how many have passed since
+        // once the wait for the next edge is done
+        uint32_t msSecondStart = msCaptured - msIntoSecond;
+        uint32_t seconds = (millis() - msSecondStart) / 1000 + 1;
+        uint32_t msEdge = msSecondStart + seconds * 1000;
+
+        while (static_cast<int32_t>(millis() - msEdge) < 0)
+        {
+            yield();
+        }
+
+        rtc.SetDateTime(RtcDateTime(dt.TotalSeconds() + seconds));
+    }
+
+    // set the RTC at the moment the seconds of the source change,
+    // where the source was just read
+    template<class T_RTC> static void SetDateTime(T_RTC& rtc, 
+        const RtcDateTime& dt, 
+        uint16_t msIntoSecond)
+    {
+        SetDateTime(rtc, dt, msIntoSecond, millis());
+    }
+};
@@ -0,0 +1,263 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+#include "RtcDS1307.h"
+#include "RtcDS3231.h"
+#include "RtcDS3234.h"
+#include "RtcPCF8563.h"
+
+// A clock kept in memory that is advanced by the 1Hz square wave of a
+// RTC module on an interrupt pin, so reading the time is a memory read
+// rather than a transaction on the bus
+//
+// Typical use...
+//    RtcSquareWaveClock Clock;
+//
+//    void ISR_ATTR onSquareWave()
+//    {
+//        Clock.Tick();
+//    }
+//
+//    setup()
+//        RtcSquareWaveClock::Configure(Rtc);
+//        attachInterrupt(digitalPinToInterrupt(RtcSquareWavePin), onSquareWave, FALLING);
+//        Clock.Sync(Rtc);
+//
+//    loop()
+//        RtcDateTime now = Clock.Now();
+//        Clock.SyncIfDue(Rtc, 3600); // verify against the RTC hourly
+//
+// NOTE: The DS3231, DS3234 and DS1307 change seconds on the falling edge
+// of their 1Hz output, so attach the interrupt to FALLING 
+//
+class RtcSquareWaveClock
+{
+public:
+    RtcSquareWaveClock() :
+        _seconds(0),
+        _ticks(0),
+        _secondsSynced(0)
+    {
+    }
+
+    // configure the square wave pin of the RTC to output 1Hz
+    template<class T_WIRE_METHOD> static void Configure(RtcDS3231<T_WIRE_METHOD>& rtc)
+    {
+        rtc.SetSquareWavePinClockFrequency(DS3231SquareWaveClock_1Hz);
+        rtc.SetSquareWavePin(DS3231SquareWavePin_ModeClock);
+    }
+
+    template<class T_SPI_METHOD> static void Configure(RtcDS3234<T_SPI_METHOD>& rtc)
+    {
+        rtc.SetSquareWavePinClockFrequency(DS3234SquareWaveClock_1Hz);
+        rtc.SetSquareWavePin(DS3234SquareWavePin_ModeClock);
+    }
+
+    template<class T_WIRE_METHOD> static void Configure(RtcDS1307<T_WIRE_METHOD>& rtc)
+    {
+        rtc.SetSquareWavePin(DS1307SquareWaveOut_1Hz);
+    }
+
+    template<class T_WIRE_METHOD> static void Configure(RtcPCF8563<T_WIRE_METHOD>& rtc)
+    {
+        rtc.SetSquareWavePin(PCF8563SquareWavePinMode_1Hz);
+    }
+
+    // call from the interrupt service routine of the square wave pin
+    void ISR_ATTR Tick()
+    {
+        _seconds++;
+        _ticks++;
+    }
+
+    RtcDateTime Now() const
+    {
+        // 32 bits can't be read in one instruction on all platforms
+        noInterrupts();
+        uint32_t seconds = _seconds;
+        interrupts();
+
+        return RtcDateTime(seconds);
+    }
+
+    // set the clock from the RTC just after a tick, so the read can't 
+    // straddle a second edge and leave a tick pending that would count
+    // the new second twice, the interrupt must already be attached
+    // delta - [out] optional, the seconds the clock was corrected by
+    // return - false if no tick came or the RTC could not be read, 
+    //     the clock is left unchanged
+    template<class T_RTC> bool Sync(T_RTC& rtc, int32_t* delta = nullptr)
+    {
+        uint32_t msStart = millis();
+        uint8_t ticks = _ticks;
+
+        while (ticks == _ticks)
+        {
+            if (millis() - msStart >= c_SyncTimeoutMs)
+            {
+                return false;
+            }
+            yield();
+        }
+        ticks = _ticks;
+
+        uint32_t seconds = rtc.GetDateTime().TotalSeconds();
+        if (rtc.LastError() != Rtc_Wire_Error_None)
+        {
+            return false;
+        }
+
+        noInterrupts();
+        // the read took so long the next second started
+        if (ticks != _ticks)
+        {
+            interrupts();
+            return false;
+        }
+        int32_t correction = seconds - _seconds;
+        _seconds = seconds;
+        interrupts();
+
+        _secondsSynced = seconds;
+        if (delta)
+        {
+            *delta = correction;
+        }
+        return true;
+    }
+
+    // verify against and set the clock from the RTC if the interval has
+    // passed since the last Sync(), catching missed ticks
+    // return - true if it did Sync() successfully
+    template<class T_RTC> bool SyncIfDue(T_RTC& rtc, uint32_t intervalSeconds)
+    {
+        if (Now().TotalSeconds() - _secondsSynced >= intervalSeconds)
+        {
+            return Sync(rtc);
+        }
+        return false;
+    }
+
+protected:
+    // a little longer than a second
+    static const uint16_t c_SyncTimeoutMs = 1100;
+
+    volatile uint32_t _seconds;
+    volatile uint8_t _ticks;
+    uint32_t _secondsSynced;
+};
+
+// A RtcSquareWaveClock that also counts the 32.768kHz output of the RTC
+// to provide timestamps within the second at about 30us resolution,
+// without any bus transactions
+//
+// The counter is provided by the sketch, usually a hardware timer or
+// counter clocked from the 32kHz pin, as an object that returns its
+// current count when called, like...
+//
+//    struct Timer1Counter
+//    {
+//        uint32_t operator()() const
+//        {
+//            return TCNT1;
+//        }
+//    };
+//    Timer1Counter Counter;
+//    RtcSubSecondClock<Timer1Counter> Clock(Counter);
+//
+// The counter may be as narrow as 16 bits as only the counts since the
+// last second edge are used; call Tick() from the 1Hz interrupt like
+// RtcSquareWaveClock
+//
+template<class T_COUNTER> class RtcSubSecondClock : 
+    public RtcSquareWaveClock
+{
+public:
+    RtcSubSecondClock(T_COUNTER& counter) :
+        _counter(counter),
+        _countAtTick(0)
+    {
+    }
+
+    // configure the RTC to output 1Hz on the square wave pin and 
+    // enable the 32kHz pin
+    template<class T_WIRE_METHOD> static void Configure(RtcDS3231<T_WIRE_METHOD>& rtc)
+    {
+        RtcSquareWaveClock::Configure(rtc);
+        rtc.Enable32kHzPin(true);
+    }
+
+    template<class T_SPI_METHOD> static void Configure(RtcDS3234<T_SPI_METHOD>& rtc)
+    {
+        RtcSquareWaveClock::Configure(rtc);
+        rtc.Enable32kHzPin(true);
+    }
+
+    // call from the interrupt service routine of the square wave pin
+    void ISR_ATTR Tick()
+    {
+        _countAtTick = _counter();
+        RtcSquareWaveClock::Tick();
+    }
+
+    // retrieve the time including the part of the current second
+    // ticks - [out] the 32.768kHz counts since the second started, 0-32767
+    RtcDateTime Now(uint16_t* ticks) const
+    {
+        noInterrupts();
+        uint32_t seconds = _seconds;
+        uint16_t elapsed = static_cast<uint16_t>(_counter() - _countAtTick);
+        interrupts();
+
+        // a missed tick would overflow into the next second
+        if (elapsed >= c_TicksPerSecond)
+        {
+            elapsed = c_TicksPerSecond - 1;
+        }
+
+        *ticks = elapsed;
+        return RtcDateTime(seconds);
+    }
+
+    using RtcSquareWaveClock::Now;
+
+    static uint32_t TicksToMicroseconds(uint16_t ticks)
+    {
+        // 1000000 / 32768 reduces to 15625 / 512
+        return (static_cast<uint32_t>(ticks) * 15625) >> 9;
+    }
+
+    static const uint16_t c_TicksPerSecond = 32768;
+
+protected:
+    T_COUNTER& _counter;
+    volatile uint32_t _countAtTick;
+};
@@ -0,0 +1,96 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+#include "RtcTimeZoneRule.h"
+
+uint32_t RtcTimeZoneRule::transitionUtc(const RtcDstTransition& transition,
+    uint16_t year,
+    int32_t offsetSeconds)
+{
+    uint8_t firstDayOfWeek = RtcDateTime(year, transition.Month, 1, 0, 0, 0).DayOfWeek();
+    uint8_t daysInMonth = RtcDateTime::DaysInMonth(year, transition.Month);
+    uint8_t day = 1 + (transition.DayOfWeek + 7 - firstDayOfWeek) % 7 +
+        (transition.Week - 1) * 7;
+
+    // week 5 means the last one, which may be the 4th
+    while (day > daysInMonth)
+    {
+        day -= 7;
+    }
+
+    RtcDateTime local(year, transition.Month, day, transition.Hour, 0, 0);
+    return local.TotalSeconds() - offsetSeconds;
+}
+
+void RtcTimeZoneRule::updateCache(uint32_t utcSeconds) const
+{
+    int32_t standardSeconds = static_cast<int32_t>(_standardMinutes) * 60;
+    int32_t dstSeconds = standardSeconds + static_cast<int32_t>(_dstMinutes) * 60;
+    uint16_t year = RtcDateTime(utcSeconds).Year();
+    uint32_t yearStart = RtcDateTime(year, 1, 1, 0, 0, 0).TotalSeconds();
+    uint32_t yearEnd = RtcDateTime(year + 1, 1, 1, 0, 0, 0).TotalSeconds();
+
+    if (_dstMinutes == 0)
+    {
+        _cacheStart = yearStart;
+        _cacheEnd = yearEnd;
+        _cacheOffset = standardSeconds;
+        return;
+    }
+
+    // the start happens in standard time and the end in daylight time
+    uint32_t start = transitionUtc(_dstStart, year, standardSeconds);
+    uint32_t end = transitionUtc(_dstEnd, year, dstSeconds);
+    // northern hemisphere is in daylight savings between the start and
+    // end of the same year, southern hemisphere is out of it
+    bool isNorthern = (start < end);
+    uint32_t first = isNorthern ? start : end;
+    uint32_t second = isNorthern ? end : start;
+    int32_t betweenOffset = isNorthern ? dstSeconds : standardSeconds;
+    int32_t outsideOffset = isNorthern ? standardSeconds : dstSeconds;
+
+    if (utcSeconds < first)
+    {
+        _cacheStart = yearStart;
+        _cacheEnd = first;
+        _cacheOffset = outsideOffset;
+    }
+    else if (utcSeconds < second)
+    {
+        _cacheStart = first;
+        _cacheEnd = second;
+        _cacheOffset = betweenOffset;
+    }
+    else
+    {
+        _cacheStart = second;
+        _cacheEnd = yearEnd;
+        _cacheOffset = outsideOffset;
+    }
+}
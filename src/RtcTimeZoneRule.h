@@ -0,0 +1,145 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+
+// when a daylight savings change happens, like the second Sunday 
+// of March at 2am
+struct RtcDstTransition
+{
+    uint8_t Month; // 1-12
+    uint8_t Week; // 1-4, 5 is the last week of the month
+    uint8_t DayOfWeek; // 0 = Sunday, see DayOfWeek enum
+    uint8_t Hour; // local time the change happens at, before the change
+};
+
+// A time zone and its daylight savings rules, used to convert between
+// UTC and local time
+//
+// Sample, US Eastern...
+//    RtcTimeZoneRule eastern(-5 * 60, 60, 
+//        { 3, 2, DayOfWeek_Sunday, 2 }, 
+//        { 11, 1, DayOfWeek_Sunday, 2 });
+//
+// The offset for the current range of time between transitions is
+// cached so conversions are only calculated when a transition is crossed
+//
+class RtcTimeZoneRule
+{
+public:
+    // standardMinutes - the offset from UTC outside of daylight savings
+    // dstMinutes - the additional offset while in daylight savings
+    // dstStart - when daylight savings starts
+    // dstEnd - when daylight savings ends
+    RtcTimeZoneRule(int16_t standardMinutes,
+            int16_t dstMinutes,
+            const RtcDstTransition& dstStart,
+            const RtcDstTransition& dstEnd) :
+        _standardMinutes(standardMinutes),
+        _dstMinutes(dstMinutes),
+        _dstStart(dstStart),
+        _dstEnd(dstEnd),
+        _cacheStart(0),
+        _cacheEnd(0),
+        _cacheOffset(0)
+    {
+    }
+
+    // a time zone without daylight savings
+    RtcTimeZoneRule(int16_t standardMinutes = 0) :
+        RtcTimeZoneRule(standardMinutes, 0, { 1, 1, 0, 0 }, { 1, 1, 0, 0 })
+    {
+    }
+
+    // the seconds to add to UTC to get local time at the given UTC time
+    // utcSeconds - as from RtcDateTime.TotalSeconds()
+    int32_t OffsetAt(uint32_t utcSeconds) const
+    {
+        if (utcSeconds < _cacheStart || utcSeconds >= _cacheEnd)
+        {
+            updateCache(utcSeconds);
+        }
+        return _cacheOffset;
+    }
+
+    uint32_t ToLocal(uint32_t utcSeconds) const
+    {
+        return utcSeconds + OffsetAt(utcSeconds);
+    }
+
+    // local times that are skipped when daylight savings starts will
+    // be converted as if they were in standard time, so 2:30am becomes
+    // 3:30am daylight time; local times that repeat when daylight 
+    // savings ends are converted as the first of the two, still in 
+    // daylight savings time
+    uint32_t ToUtc(uint32_t localSeconds) const
+    {
+        int32_t standardSeconds = static_cast<int32_t>(_standardMinutes) * 60;
+        int32_t dstSeconds = standardSeconds + 
+            static_cast<int32_t>(_dstMinutes) * 60;
+        uint32_t utcDst = localSeconds - dstSeconds;
+
+        // only when the daylight savings offset is the one in effect at 
+        // that time is the local time a daylight savings time
+        if (_dstMinutes != 0 && OffsetAt(utcDst) == dstSeconds)
+        {
+            return utcDst;
+        }
+        return localSeconds - standardSeconds;
+    }
+
+    RtcDateTime ToLocal(const RtcDateTime& utc) const
+    {
+        return RtcDateTime(ToLocal(utc.TotalSeconds()));
+    }
+
+    RtcDateTime ToUtc(const RtcDateTime& local) const
+    {
+        return RtcDateTime(ToUtc(local.TotalSeconds()));
+    }
+
+protected:
+    int16_t _standardMinutes;
+    int16_t _dstMinutes;
+    RtcDstTransition _dstStart;
+    RtcDstTransition _dstEnd;
+
+    // the range of UTC time that _cacheOffset applies to
+    mutable uint32_t _cacheStart;
+    mutable uint32_t _cacheEnd;
+    mutable int32_t _cacheOffset;
+
+    void updateCache(uint32_t utcSeconds) const;
+
+    // the UTC seconds of the transition in the given year
+    static uint32_t transitionUtc(const RtcDstTransition& transition, 
+        uint16_t year, 
+        int32_t offsetSeconds);
+};
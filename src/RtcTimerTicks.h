@@ -0,0 +1,192 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+#include "RtcDateTime.h"
+#include "RtcPCF8563.h"
+#include "RtcSecondEdge.h"
+
+// A periodic tick from the countdown timer of the PCF8563, the timer 
+// reloads itself and pulses the INT pin each time it reaches zero, so
+// counting the pulses on an interrupt needs no bus transactions and the
+// timer flag never needs to be latched
+//
+// The ticks keep counting while the MCU sleeps, with the INT pin waking
+// it, so they can be used to advance a scheduler after waking...
+//
+//    RtcTimerTicks Ticks;
+//
+//    void ISR_ATTR onTimer()
+//    {
+//        Ticks.Tick();
+//    }
+//
+//    setup()
+//        attachInterrupt(digitalPinToInterrupt(RtcInterruptPin), onTimer, FALLING);
+//        Ticks.Start(Rtc, PCF8563TimerMode_Seconds, 1);
+//        Alarms.Sync(Ticks.Now());
+//
+//    loop()
+//        Alarms.ProcessAlarms(alarmCallback, nullptr);
+//        // deep sleep until the INT pin wakes it at the next tick
+//        uint32_t ticks = Ticks.TakeTicks(); // ticks since the last call
+//        Alarms.Sync(Ticks.Now(), true); // woken at a tick, a second edge
+//
+// NOTE: the INT pin is open drain and active low, so it needs a pullup
+// and the interrupt attached to FALLING
+//
+class RtcTimerTicks
+{
+public:
+    RtcTimerTicks() :
+        _ticks(0),
+        _ticksTaken(0),
+        _periodTicks(0),
+        _secondsStart(0)
+    {
+    }
+
+    // start the timer of the RTC pulsing the INT pin every count
+    // periods of the given mode and reset the tick count, the interrupt 
+    // should already be attached
+    // The timer is started just after the seconds change, waiting up to
+    // a second for it, so the ticks stay in phase with the RTC seconds
+    // count - 1-255, the number of timer periods between ticks
+    // return - false if the seconds change was not seen, then Now() may 
+    //     lag the RTC by up to a second, or if the RTC could not be read
+    //     at all, then the timer is not started
+    template<class T_WIRE_METHOD> bool Start(RtcPCF8563<T_WIRE_METHOD>& rtc,
+        PCF8563TimerMode mode,
+        uint8_t count)
+    {
+        RtcDateTime now;
+        bool atEdge = RtcSecondEdge::GetDateTime(rtc, &now);
+
+        if (!atEdge)
+        {
+            now = rtc.GetDateTime();
+            if (rtc.LastError() != Rtc_Wire_Error_None)
+            {
+                return false;
+            }
+        }
+
+        _periodTicks = static_cast<uint32_t>(timerPeriod(mode)) * count;
+        _secondsStart = now.TotalSeconds();
+
+        noInterrupts();
+        _ticks = 0;
+        interrupts();
+        _ticksTaken = 0;
+
+        // SetTimer() enables the pulsed interrupt (TI_TP)
+        rtc.SetTimer(mode, count);
+
+        return atEdge;
+    }
+
+    template<class T_WIRE_METHOD> void Stop(RtcPCF8563<T_WIRE_METHOD>& rtc)
+    {
+        rtc.StopTimer();
+    }
+
+    // call from the interrupt service routine of the INT pin
+    void ISR_ATTR Tick()
+    {
+        _ticks++;
+    }
+
+    // the ticks since Start()
+    uint32_t Ticks() const
+    {
+        // 32 bits can't be read in one instruction on all platforms
+        noInterrupts();
+        uint32_t ticks = _ticks;
+        interrupts();
+
+        return ticks;
+    }
+
+    // the ticks since the last call, to advance a scheduler by
+    uint32_t TakeTicks()
+    {
+        uint32_t ticks = Ticks();
+        uint32_t taken = ticks - _ticksTaken;
+
+        _ticksTaken = ticks;
+        return taken;
+    }
+
+    // the time of the period between ticks in 4096ths of a second
+    uint32_t PeriodTicks() const
+    {
+        return _periodTicks;
+    }
+
+    uint32_t TicksToMilliseconds(uint32_t ticks) const
+    {
+        return (static_cast<uint64_t>(ticks) * _periodTicks * 1000) / c_TimerClock;
+    }
+
+    // the time at the last tick, from the time read by Start() at the 
+    // start of its second and the ticks since, in whole seconds
+    RtcDateTime Now() const
+    {
+        uint64_t elapsed = static_cast<uint64_t>(Ticks()) * _periodTicks;
+
+        return RtcDateTime(_secondsStart + static_cast<uint32_t>(elapsed / c_TimerClock));
+    }
+
+    // the fastest timer clock of the PCF8563
+    static const uint16_t c_TimerClock = 4096;
+
+protected:
+    volatile uint32_t _ticks;
+    uint32_t _ticksTaken;
+    uint32_t _periodTicks; // 4096ths of a second between ticks
+    uint32_t _secondsStart;
+
+    // a period of the timer clock in 4096ths of a second
+    static uint32_t timerPeriod(PCF8563TimerMode mode)
+    {
+        switch (mode)
+        {
+        case PCF8563TimerMode_4096thOfASecond:
+            return 1;
+        case PCF8563TimerMode_64thOfASecond:
+            return c_TimerClock / 64;
+        case PCF8563TimerMode_Seconds:
+            return c_TimerClock;
+        case PCF8563TimerMode_Minutes:
+            return static_cast<uint32_t>(c_TimerClock) * 60;
+        default:
+            return 0;
+        }
+    }
+};
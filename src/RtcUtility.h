@@ -60,6 +60,22 @@ License along with Rtc.  If not, see
 #define RTC_NO_STL 1
 #endif
 
+// the most bytes a single Wire transaction can hold, memory transfers that 
+// are larger are split into several transactions of this size
+// it is read from the Wire library, so include Wire.h before the RTC headers
+// or define it to match the buffer of the Wire library in use
+#if !defined(RTC_WIRE_BUFFER_SIZE)
+
+#if defined(I2C_BUFFER_LENGTH) // ESP32
+#define RTC_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH) // AVR, ESP8266, and many others
+#define RTC_WIRE_BUFFER_SIZE BUFFER_LENGTH
+#else
+#define RTC_WIRE_BUFFER_SIZE 32
+#endif
+
+#endif // !defined(RTC_WIRE_BUFFER_SIZE)
+
 // While WIRE has return codes, there is no standard definition of what they are
 // within any headers; they are only documented on the website here
 // https://www.arduino.cc/reference/en/language/functions/communication/wire/endtransmission/
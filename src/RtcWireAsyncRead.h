@@ -0,0 +1,188 @@
+/*-------------------------------------------------------------------------
+RTC library
+
+Written by Michael C. Miller.
+
+I invest time and resources providing this open source code,
+please support me by dontating (see https://github.com/Makuna/Rtc)
+
+-------------------------------------------------------------------------
+This file is part of the Makuna/Rtc library.
+
+Rtc is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+Rtc is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with Rtc.  If not, see
+<http://www.gnu.org/licenses/>.
+-------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "RtcUtility.h"
+
+enum RtcAsyncState
+{
+    RtcAsyncState_Idle,
+    RtcAsyncState_Addressing, // the next poll writes the register address
+    RtcAsyncState_Requesting, // the next poll requests and collects the data
+    RtcAsyncState_Complete,
+    RtcAsyncState_Error, // see LastError()
+};
+
+// A register read broken into two steps so that the sketch can do other
+// work between writing the register address and reading the data, 
+// rather than doing the whole read in one call
+//
+// Each call to Poll() does the next step of the read, the first writes 
+// the register address and the second requests and collects the data.
+// Each step still blocks while it is on the bus, as endTransmission() 
+// and requestFrom() of the Arduino Wire API only return once their 
+// transfer is done, so this shortens the longest time spent in one call
+// but is not a non-blocking read.
+//
+// The drivers provide Start methods to begin a read and overloads of 
+// their Get methods to decode a completed one, like...
+//
+//    RtcWireAsyncRead<TwoWire> request(Wire);
+//    Rtc.StartGetDateTime(request);
+//    ...
+//    if (request.Poll() == RtcAsyncState_Complete)
+//    {
+//        RtcDateTime now = Rtc.GetDateTime(request);
+//    }
+//
+// V_SIZE - the most bytes the request can read, up to the Wire buffer size
+//
+template<class T_WIRE_METHOD, uint8_t V_SIZE = 8> class RtcWireAsyncRead
+{
+public:
+    RtcWireAsyncRead(T_WIRE_METHOD& wire) :
+        _wire(wire),
+        _state(RtcAsyncState_Idle),
+        _lastError(Rtc_Wire_Error_None),
+        _deviceAddress(0),
+        _addressSize(0),
+        _regAddress(0),
+        _count(0)
+    {
+    }
+
+    // start a read, it will not touch the bus until Poll() is called
+    // deviceAddress - the I2C address of the device
+    // regAddress - the register or memory address to read from
+    // count - the bytes to read, no more than V_SIZE
+    // addressSize - the bytes of regAddress to write, 2 for EEPROM
+    // return - false if still busy with a previous read or count is too large
+    bool Start(uint8_t deviceAddress, 
+        uint16_t regAddress, 
+        uint8_t count, 
+        uint8_t addressSize = 1)
+    {
+        if (IsBusy() || count > V_SIZE)
+        {
+            return false;
+        }
+
+        _deviceAddress = deviceAddress;
+        _regAddress = regAddress;
+        _addressSize = addressSize;
+        _count = count;
+        _lastError = Rtc_Wire_Error_None;
+        _state = RtcAsyncState_Addressing;
+        return true;
+    }
+
+    // do the next step of the read
+    // return - the state after the step
+    RtcAsyncState Poll()
+    {
+        switch (_state)
+        {
+        case RtcAsyncState_Addressing:
+            _wire.beginTransmission(_deviceAddress);
+            if (_addressSize > 1)
+            {
+                _wire.write(_regAddress >> 8);
+            }
+            _wire.write(_regAddress & 0xff);
+            _lastError = _wire.endTransmission();
+            _state = (_lastError == Rtc_Wire_Error_None) ? 
+                RtcAsyncState_Requesting : 
+                RtcAsyncState_Error;
+            break;
+
+        case RtcAsyncState_Requesting:
+            // requestFrom() returns once all the data has been received
+            if (_wire.requestFrom(_deviceAddress, _count) != _count)
+            {
+                _lastError = Rtc_Wire_Error_Unspecific;
+                _state = RtcAsyncState_Error;
+            }
+            else
+            {
+                for (uint8_t index = 0; index < _count; index++)
+                {
+                    _data[index] = _wire.read();
+                }
+                _state = RtcAsyncState_Complete;
+            }
+            break;
+
+        default:
+            break;
+        }
+        return _state;
+    }
+
+    // stop waiting on a read, like after a timeout
+    void Cancel()
+    {
+        _state = RtcAsyncState_Idle;
+    }
+
+    bool IsBusy() const
+    {
+        return (_state == RtcAsyncState_Addressing ||
+            _state == RtcAsyncState_Requesting);
+    }
+
+    RtcAsyncState State() const
+    {
+        return _state;
+    }
+
+    uint8_t LastError() const
+    {
+        return _lastError;
+    }
+
+    // the bytes read, valid when the state is complete
+    const uint8_t* Data() const
+    {
+        return _data;
+    }
+
+    uint8_t Count() const
+    {
+        return _count;
+    }
+
+protected:
+    T_WIRE_METHOD& _wire;
+    RtcAsyncState _state;
+    uint8_t _lastError;
+    uint8_t _deviceAddress;
+    uint8_t _addressSize;
+    uint16_t _regAddress;
+    uint8_t _count;
+    uint8_t _data[V_SIZE];
+};